@@ -1,91 +1,186 @@
 #include "BinauralConvolver.h"
 #include "BinaryData.h"
+#include <limits>
 
-// ===================== small helper thread wrapper =====================
 namespace
 {
-    struct SimpleThread final : public juce::Thread
+    // ===================== fused mixing kernels =====================
+    // Corner weights ramp linearly from w0 (start of block) to w1 (end of block), which
+    // removes the zipper noise of per-block weight steps. The loops carry no state
+    // between iterations (the ramp is base + n * step), so the compiler vectorises them.
+
+    struct WeightRamp
+    {
+        float start[4];
+        float step[4];
+    };
+
+    template <typename Weights>
+    WeightRamp makeWeightRamp (const Weights& w0, const Weights& w1, int numSamples) noexcept
     {
-        using Fn = std::function<void()>;
-        Fn fn;
+        const float inv = 1.0f / (float) juce::jmax (1, numSamples);
+        return { { w0.a, w0.b, w0.c, w0.d },
+                 { (w1.a - w0.a) * inv, (w1.b - w0.b) * inv,
+                   (w1.c - w0.c) * inv, (w1.d - w0.d) * inv } };
+    }
 
-        SimpleThread(const juce::String& name, Fn f)
-        : juce::Thread(name), fn(std::move(f)) {}
+    // out[n] += sum_k w_k(n) * corner_k[n]   (through the distance stage when given)
+    template <bool withDistance>
+    void mixBilinearRamp (float* out, const float* const* corners,
+                          const WeightRamp& w, int numSamples,
+                          DistanceModel::Stage* distance = nullptr) noexcept
+    {
+        const float* a = corners[0];
+        const float* b = corners[1];
+        const float* c = corners[2];
+        const float* d = corners[3];
 
-        void run() override
+        for (int n = 0; n < numSamples; ++n)
         {
-            if (fn) fn();
+            const float t = (float) (n + 1);
+
+            const float mix = (w.start[0] + t * w.step[0]) * a[n]
+                            + (w.start[1] + t * w.step[1]) * b[n]
+                            + (w.start[2] + t * w.step[2]) * c[n]
+                            + (w.start[3] + t * w.step[3]) * d[n];
+
+            if constexpr (withDistance)
+                out[n] += distance->process (mix, t);
+            else
+                out[n] += mix;
         }
-    };
-}
+    }
 
-BinauralConvolver::BinauralConvolver()
-{
-    // Create all 16 convolvers (4 grid points × 2 ears × 2 sets)
+    // Both 4-corner mixes, the A -> B crossfade, the distance stage and the accumulation
+    // into the caller's output in one pass over memory. A is whatever fades out (one
+    // state, or the older states merged), B the newest state.
+    // gainA(n) = max (0, gainAStart - n * gainStep), gainB(n) = 1 - gainA(n).
+    template <bool withDistance>
+    void mixBilinearCrossfade (float* out,
+                               const float* const* cornersA, const WeightRamp& wA,
+                               const float* const* cornersB, const WeightRamp& wB,
+                               float gainAStart, float gainStep, int numSamples,
+                               DistanceModel::Stage* distance = nullptr) noexcept
+    {
+        const float* aa = cornersA[0];
+        const float* ab = cornersA[1];
+        const float* ac = cornersA[2];
+        const float* ad = cornersA[3];
+        const float* ba = cornersB[0];
+        const float* bb = cornersB[1];
+        const float* bc = cornersB[2];
+        const float* bd = cornersB[3];
+
+        for (int n = 0; n < numSamples; ++n)
+        {
+            const float t = (float) (n + 1);
+
+            const float mixA = (wA.start[0] + t * wA.step[0]) * aa[n]
+                             + (wA.start[1] + t * wA.step[1]) * ab[n]
+                             + (wA.start[2] + t * wA.step[2]) * ac[n]
+                             + (wA.start[3] + t * wA.step[3]) * ad[n];
+
+            const float mixB = (wB.start[0] + t * wB.step[0]) * ba[n]
+                             + (wB.start[1] + t * wB.step[1]) * bb[n]
+                             + (wB.start[2] + t * wB.step[2]) * bc[n]
+                             + (wB.start[3] + t * wB.step[3]) * bd[n];
 
-    // Set A
-    convA_aL = std::make_unique<juce::dsp::Convolution>();
-    convA_aR = std::make_unique<juce::dsp::Convolution>();
-    convA_bL = std::make_unique<juce::dsp::Convolution>();
-    convA_bR = std::make_unique<juce::dsp::Convolution>();
-    convA_cL = std::make_unique<juce::dsp::Convolution>();
-    convA_cR = std::make_unique<juce::dsp::Convolution>();
-    convA_dL = std::make_unique<juce::dsp::Convolution>();
-    convA_dR = std::make_unique<juce::dsp::Convolution>();
+            const float gA = juce::jmax (0.0f, gainAStart - (float) n * gainStep);
+            const float mix = mixB + gA * (mixA - mixB);
+
+            if constexpr (withDistance)
+                out[n] += distance->process (mix, t);
+            else
+                out[n] += mix;
+        }
+    }
+
+    WeightRamp scaledWeightRamp (const WeightRamp& w, float gain) noexcept
+    {
+        WeightRamp r;
 
-    // Set B
-    convB_aL = std::make_unique<juce::dsp::Convolution>();
-    convB_aR = std::make_unique<juce::dsp::Convolution>();
-    convB_bL = std::make_unique<juce::dsp::Convolution>();
-    convB_bR = std::make_unique<juce::dsp::Convolution>();
-    convB_cL = std::make_unique<juce::dsp::Convolution>();
-    convB_cR = std::make_unique<juce::dsp::Convolution>();
-    convB_dL = std::make_unique<juce::dsp::Convolution>();
-    convB_dR = std::make_unique<juce::dsp::Convolution>();
+        for (int k = 0; k < 4; ++k)
+        {
+            r.start[k] = w.start[k] * gain;
+            r.step[k]  = w.step[k] * gain;
+        }
+
+        return r;
+    }
 }
 
 BinauralConvolver::~BinauralConvolver()
 {
-    stopLoaderThread();
+    workerPool->removeClient (*this);
 }
 
 void BinauralConvolver::prepare (double sampleRate, int maxBlockSize)
 {
-    fs = sampleRate;
+    // No set loads while the engine is re-prepared (waits for one in progress)
+    workerPool->removeClient (*this);
+    loaderRegistered = false;
+
+    maxBlockSize = juce::jmax (1, maxBlockSize);
+
+    // Hosts prepare again on transport changes, bypass and device changes, mostly with the
+    // same settings. Only what depends on a changed setting is rebuilt; an unchanged
+    // configuration keeps the bank, the engine and the filters in its slots (so set A is
+    // found there by initialiseAtPositionDegrees) and only clears the playback state.
+    const bool rateChanged  = ! cacheBuilt || sampleRate != fs;
+    const bool bankChanged  = rateChanged || requestedHrirTaps != bankHrirTaps;
+    const bool blockChanged = maxBlockSize != preparedBlockSize;
+
+    if (rateChanged)
+    {
+        fs = sampleRate;
+
+        // Crossfade duration: 5..30 ms depending on the angular speed
+        xfadeMaxSamples = (int) juce::jlimit (64.0, 48000.0, sampleRate * 0.03);
+        xfadeMinSamples = (int) juce::jlimit (16.0, (double) xfadeMaxSamples, sampleRate * 0.005);
+
+        nearFieldShelfCoeff = DistanceModel::shelfCoefficient (sampleRate);
+    }
 
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = (juce::uint32) maxBlockSize;
-    spec.numChannels = 1;
+    if (blockChanged)
+    {
+        preparedBlockSize = maxBlockSize;
 
-    // Prepare all convolvers
-    convA_aL->prepare (spec); convA_aR->prepare (spec);
-    convA_bL->prepare (spec); convA_bR->prepare (spec);
-    convA_cL->prepare (spec); convA_cR->prepare (spec);
-    convA_dL->prepare (spec); convA_dR->prepare (spec);
+        // Preallocate temps to max block (avoid realloc during playback)
+        ensureTempsCapacity (maxBlockSize);
+    }
 
-    convB_aL->prepare (spec); convB_aR->prepare (spec);
-    convB_bL->prepare (spec); convB_bR->prepare (spec);
-    convB_cL->prepare (spec); convB_cR->prepare (spec);
-    convB_dL->prepare (spec); convB_dR->prepare (spec);
+    if (bankChanged)
+        buildHrirBank();
 
-    // Crossfade duration: 30ms
-    xfadeTotal = (int) juce::jlimit (64.0, 48000.0, sampleRate * 0.03);
+    if (bankChanged || blockChanged)
+    {
+        // New bank or new partitions: no slot holds a valid filter
+        for (auto& slot : slots)
+            slot.loaded = false;
 
-    // Preallocate temps to max block (avoid realloc during playback)
-    ensureTempsCapacity (maxBlockSize);
+        // Partitions sized for the longest IR; the reduced bank's filters use fewer of them
+        engine.prepare (numSlots, preparedBlockSize, warmupSamples);
+    }
 
     reset();
 
+    workerPool->addClient (*this);
+    loaderRegistered = true;
+}
+
+void BinauralConvolver::buildHrirBank()
+{
     // Build maps (original filename -> symbol) once
-    originalToSymbol.clear();
-    originalToSymbol.reserve((size_t) BinaryData::namedResourceListSize);
-    for (int i = 0; i < BinaryData::namedResourceListSize; ++i)
-        originalToSymbol.emplace(BinaryData::originalFilenames[i], BinaryData::namedResourceList[i]);
+    if (originalToSymbol.empty())
+    {
+        originalToSymbol.reserve((size_t) BinaryData::namedResourceListSize);
+        for (int i = 0; i < BinaryData::namedResourceListSize; ++i)
+            originalToSymbol.emplace(BinaryData::originalFilenames[i], BinaryData::namedResourceList[i]);
+    }
 
     // Decode + resample all HRIR wavs into cache (3MB → totally fine)
-    hrirCache.clear();
-    hrirCache.reserve((size_t) BinaryData::namedResourceListSize);
+    HrirCache fullCache;
+    fullCache.reserve((size_t) BinaryData::namedResourceListSize);
 
     for (int i = 0; i < BinaryData::namedResourceListSize; ++i)
     {
@@ -114,126 +209,202 @@ void BinauralConvolver::prepare (double sampleRate, int maxBlockSize)
         if (peak > 1.0f)
             irResampled.applyGain(0.9f / peak);
 
-        hrirCache.emplace(original, std::move(irResampled));
+        fullCache.emplace(original, std::move(irResampled));
     }
 
+    // Onset alignment + truncation (the full-length IRs are only kept for the report)
+    const int onset = findBankOnset (fullCache, juce::jmax (1, juce::roundToInt (fs * 0.0001)));
+    const auto scaleTaps = [this](int tapsAt44k) { return juce::roundToInt (tapsAt44k * fs / 44100.0); };
+
+    hrirCache = buildTruncatedBank (fullCache, onset, scaleTaps (requestedHrirTaps), fs, bankReport);
+
+    reducedHrirCache.clear();
+    reducedBankReport = {};
+
+    if (scaleTaps (reducedHrirTapsAt44k) < bankReport.taps)
+        reducedHrirCache = buildTruncatedBank (fullCache, onset, scaleTaps (reducedHrirTapsAt44k), fs, reducedBankReport);
+
+    hrirGrid = buildHrirGrid (hrirCache);
+    reducedHrirGrid = buildHrirGrid (reducedHrirCache);
+
+    bankHrirTaps = requestedHrirTaps;
     cacheBuilt = true;
 
-    DBG("BinauralConvolver: HRIR cache built. Count=" + juce::String((int) hrirCache.size()));
+    warmupSamples = 0;
+    for (const auto& entry : hrirCache)
+        warmupSamples = juce::jmax (warmupSamples, entry.second.getNumSamples());
 
-    startLoaderThread();
+    DBG("BinauralConvolver: HRIR cache built. Count=" + juce::String((int) hrirCache.size())
+        + " taps=" + juce::String(bankReport.taps) + "/" + juce::String(bankReport.fullTaps)
+        + " error=" + juce::String(bankReport.meanSpectralErrorDb, 2) + " dB");
 }
 
 void BinauralConvolver::reset()
 {
-    auto resetConv = [](std::unique_ptr<juce::dsp::Convolution>& c) {
-        if (c) c->reset();
-    };
-
-    resetConv (convA_aL); resetConv (convA_aR);
-    resetConv (convA_bL); resetConv (convA_bR);
-    resetConv (convA_cL); resetConv (convA_cR);
-    resetConv (convA_dL); resetConv (convA_dR);
+    engine.reset();
 
-    resetConv (convB_aL); resetConv (convB_aR);
-    resetConv (convB_bL); resetConv (convB_bR);
-    resetConv (convB_cL); resetConv (convB_cR);
-    resetConv (convB_dL); resetConv (convB_dR);
-
-    hasA = false;
+    states = {};
+    numStates = 0;
+    incoming = {};
+    audibleSlots.store (0);
     hasBReady.store(false);
-    switching = false;
     xfadeLeft = 0;
 
-    aAzLower = aAzUpper = aElLower = aElUpper = 0;
-    bAzLower = bAzUpper = bElLower = bElUpper = 0;
-    aAzFraction = aElFraction = 0.0f;
-    bAzFraction = bElFraction = 0.0f;
+    reloadRequested = false;
+    silentSamples = 0;
+    distancePrev = DistanceModel::Params{};
+    distanceState = {};
+
+    hasLastPosition = false;
+    travelledDegrees = 0.0f;
+    samplesSincePosition = 0;
+    degreesPerSample = 0.0f;
 
     // clear pending request
+    pendingCell.store(0);
+    lastRequestedCell = 0;
+}
+
+bool BinauralConvolver::hasPendingJob (EngineWorkerPool::Priority& priority) const noexcept
+{
+    // While a set B is ready, its slots are about to become audible, so a newer request waits
+    // until B has joined the audible states and is then loaded against them. hasBReady only
+    // turns true here, so no state becomes audible during a load (states only drop out).
+    const auto pending = pendingCell.load (std::memory_order_relaxed);
+
+    // A cell for the current output is needed now; a lookahead cell only later
+    priority = (pending & prefetchBit) != 0 ? EngineWorkerPool::Priority::prefetch
+                                            : EngineWorkerPool::Priority::now;
+    return pending != 0 && ! hasBReady.load (std::memory_order_acquire);
+}
+
+void BinauralConvolver::runPendingJob()
+{
+    // A transport jump is rewriting the slots: the request stays pending for the next poll
+    bool idle = false;
+    if (! loaderBusy.compare_exchange_strong (idle, true, std::memory_order_acquire))
+        return;
+
+    const auto packed = pendingCell.exchange(0, std::memory_order_acquire);
+    const auto requestTicks = pendingRequestTicks.load();
+    if (packed == 0 || ! cacheBuilt)
+    {
+        loaderBusy.store(false);
+        return;
+    }
+
+    int azLower, azUpper, elLower, elUpper;
+    unpackCell(packed, azLower, azUpper, elLower, elUpper);
+
+    // Load Set B OFF the audio thread: only the corners no audible state holds. A state
+    // that fades out meanwhile only frees slots, so the mask read here stays safe.
+    const bool reduced = useReducedHrirs.load() && ! reducedHrirCache.empty();
+    const bool ok = loadCellIntoSlots (reduced, azLower, azUpper, elLower, elUpper,
+                                       audibleSlots.load (std::memory_order_acquire), incoming.corners);
+    if (! ok)
     {
-        const juce::ScopedLock sl(requestLock);
-        pending = PendingRequest{};
+        loaderBusy.store(false);
+        return;
     }
+
+    // Set B state (safe: only written here; audio thread reads only after hasBReady)
+    incoming.azLower = azLower;
+    incoming.azUpper = azUpper;
+    incoming.elLower = elLower;
+    incoming.elUpper = elUpper;
+    unpackFractions (packed, incoming.azFraction, incoming.elFraction);
+    incoming.reduced = reduced;
+    incoming.prefetched = (packed & prefetchBit) != 0;
+    bRequestTicks = requestTicks;
+
+    // The new filters are installed: publishing B makes them live for the audio thread
+    hasBReady.store(true, std::memory_order_release);
+    loaderBusy.store(false);
+
+    if (auto* sink = telemetry.load (std::memory_order_acquire))
+        sink->reportSetLoaded (juce::Time::highResolutionTicksToSeconds (
+            juce::Time::getHighResolutionTicks() - requestTicks) * 1000.0);
 }
 
-void BinauralConvolver::startLoaderThread()
+void BinauralConvolver::requestLoadSetB (int azLower, int azUpper, int elLower, int elUpper,
+                                        float azFrac, float elFrac)
 {
-    if (loaderThread)
+    // Do not enqueue if not built
+    if (! cacheBuilt)
+        return;
+
+    const auto packed = packCell(azLower, azUpper, elLower, elUpper);
+
+    // Already asked for this cell: the loader has it (or will pick it up)
+    if (packed == lastRequestedCell)
         return;
 
-    threadShouldExit.store(false);
-    loaderThread = std::make_unique<SimpleThread>("HRIR_SetB_Loader", [this] { loaderThreadMain(); });
-    loaderThread->startThread(juce::Thread::Priority::normal);
+    lastRequestedCell = packed;
+    pendingRequestTicks.store(juce::Time::getHighResolutionTicks());
+    const auto previous = pendingCell.exchange(packed | packFractions (azFrac, elFrac), std::memory_order_release);
+    workerPool->notify();
+
+    if (auto* sink = telemetry.load (std::memory_order_relaxed))
+        sink->reportCellSwitchRequest (previous != 0); // replaced a request the loader never picked up
 }
 
-void BinauralConvolver::stopLoaderThread()
+void BinauralConvolver::cancelPendingRequest() noexcept
 {
-    if (! loaderThread)
-        return;
+    auto pending = pendingCell.load();
 
-    threadShouldExit.store(true);
-    requestEvent.signal();
-    loaderThread->stopThread(2000);
-    loaderThread.reset();
+    if (pending != 0 && (pending & prefetchBit) == 0)
+        pendingCell.compare_exchange_strong (pending, 0);
 }
 
-void BinauralConvolver::loaderThreadMain()
+bool BinauralConvolver::waitForPendingLoad (int timeoutMs)
 {
-    while (! threadShouldExit.load())
+    if (! loaderRegistered)
+        return true;
+
+    const auto deadline = juce::Time::getMillisecondCounter() + (juce::uint32) timeoutMs;
+
+    // A request that waits for a crossfade needs the audio thread to run first
+    while ((pendingCell.load() != 0 && ! hasBReady.load()) || loaderBusy.load())
     {
-        requestEvent.wait(200); // wake periodically; also wakes on signal
+        if (juce::Time::getMillisecondCounter() > deadline)
+            return false;
 
-        if (threadShouldExit.load())
-            break;
+        juce::Thread::sleep (1);
+    }
 
-        PendingRequest req;
-        {
-            const juce::ScopedLock sl(requestLock);
-            if (! pending.valid)
-                continue;
-            req = pending;
-            pending.valid = false;
-        }
+    return true;
+}
 
-        // Load Set B OFF the audio thread
-        hasBReady.store(false);
+juce::uint64 BinauralConvolver::packCell (int azLower, int azUpper, int elLower, int elUpper) noexcept
+{
+    auto byte = [](int deg) { return (juce::uint64) (juce::uint8) (deg + 128); };
 
-        const bool ok = loadSetBFromCache(req.azLower, req.azUpper, req.elLower, req.elUpper);
-        if (! ok)
-            continue;
+    return (juce::uint64 (1) << 32)
+         | byte(azLower) | (byte(azUpper) << 8) | (byte(elLower) << 16) | (byte(elUpper) << 24);
+}
 
-        // Set B state (safe: only written here; audio thread reads only after hasBReady)
-        bAzLower = req.azLower;
-        bAzUpper = req.azUpper;
-        bElLower = req.elLower;
-        bElUpper = req.elUpper;
-        bAzFraction = req.azFrac;
-        bElFraction = req.elFrac;
+void BinauralConvolver::unpackCell (juce::uint64 packed, int& azLower, int& azUpper, int& elLower, int& elUpper) noexcept
+{
+    auto deg = [packed](int shift) { return (int) ((packed >> shift) & 0xff) - 128; };
 
-        hasBReady.store(true);
-    }
+    azLower = deg(0);
+    azUpper = deg(8);
+    elLower = deg(16);
+    elUpper = deg(24);
 }
 
-void BinauralConvolver::requestLoadSetB (int azLower, int azUpper, int elLower, int elUpper,
-                                        float azFrac, float elFrac)
+juce::uint64 BinauralConvolver::packFractions (float azFrac, float elFrac) noexcept
 {
-    // Do not enqueue if not built
-    if (! cacheBuilt)
-        return;
+    // Only the starting weights of set B: the audio thread ramps them on from there
+    auto bits = [](float f) { return (juce::uint64) juce::roundToInt (juce::jlimit (0.0f, 1.0f, f) * 32767.0f); };
 
-    {
-        const juce::ScopedLock sl(requestLock);
-        pending.azLower = azLower;
-        pending.azUpper = azUpper;
-        pending.elLower = elLower;
-        pending.elUpper = elUpper;
-        pending.azFrac = azFrac;
-        pending.elFrac = elFrac;
-        pending.valid = true;
-    }
+    return (bits (azFrac) << 34) | (bits (elFrac) << 49);
+}
 
-    requestEvent.signal();
+void BinauralConvolver::unpackFractions (juce::uint64 packed, float& azFrac, float& elFrac) noexcept
+{
+    azFrac = (float) ((packed >> 34) & 0x7fff) / 32767.0f;
+    elFrac = (float) ((packed >> 49) & 0x7fff) / 32767.0f;
 }
 
 //==============================================================================
@@ -355,66 +526,267 @@ juce::AudioBuffer<float> BinauralConvolver::resampleMono (const juce::AudioBuffe
     return out;
 }
 
-bool BinauralConvolver::loadConvolverFromCache (juce::dsp::Convolution& conv,
-                                                int azDeg, int elDeg, bool leftEar)
+std::vector<const juce::AudioBuffer<float>*> BinauralConvolver::buildHrirGrid (const HrirCache& cache) const
+{
+    const int numAz = (azimuthMax - azimuthMin) / azimuthGridStep + 1;
+    const int numEl = (elevationMax - elevationMin) / elevationGridStep + 1;
+
+    std::vector<const juce::AudioBuffer<float>*> grid;
+
+    if (cache.empty())
+        return grid;
+
+    grid.assign ((size_t) (numAz * numEl * 2), nullptr);
+
+    for (int a = 0; a < numAz; ++a)
+    {
+        for (int e = 0; e < numEl; ++e)
+        {
+            for (int ear = 0; ear < 2; ++ear)
+            {
+                // IMPORTANT: keep your L/R swap decision
+                const juce::String side = ear == 0 ? "R" : "L";
+
+                const juce::String originalFilename =
+                    "azi_" + juce::String (azimuthMin + a * azimuthGridStep) +
+                    "_ele_" + juce::String (elevationMin + e * elevationGridStep) +
+                    "_" + side + ".wav";
+
+                auto it = cache.find (originalFilename);
+                if (it == cache.end())
+                {
+                    DBG("HRIR not in cache: " + originalFilename);
+                    continue;
+                }
+
+                grid[(size_t) ((a * numEl + e) * 2 + ear)] = &it->second;
+            }
+        }
+    }
+
+    return grid;
+}
+
+const juce::AudioBuffer<float>* BinauralConvolver::findHrir (bool reduced, int azDeg, int elDeg, bool leftEar) const noexcept
+{
+    const auto& grid = reduced ? reducedHrirGrid : hrirGrid;
+    const int numAz = (azimuthMax - azimuthMin) / azimuthGridStep + 1;
+    const int numEl = (elevationMax - elevationMin) / elevationGridStep + 1;
+    const int a = (azDeg - azimuthMin) / azimuthGridStep;
+    const int e = (elDeg - elevationMin) / elevationGridStep;
+
+    if (grid.empty() || a < 0 || a >= numAz || e < 0 || e >= numEl
+        || azDeg != azimuthMin + a * azimuthGridStep || elDeg != elevationMin + e * elevationGridStep)
+        return nullptr;
+
+    return grid[(size_t) ((a * numEl + e) * 2 + (leftEar ? 0 : 1))];
+}
+
+bool BinauralConvolver::installHrirPair (bool reduced, int slot, int azDeg, int elDeg)
 {
     if (! cacheBuilt)
         return false;
 
-    // IMPORTANT: keep your L/R swap decision
-    const juce::String side = leftEar ? "R" : "L";
+    const auto* irL = findHrir (reduced, azDeg, elDeg, true);
+    const auto* irR = findHrir (reduced, azDeg, elDeg, false);
 
-    const juce::String originalFilename =
-        "azi_" + juce::String(azDeg) +
-        "_ele_" + juce::String(elDeg) +
-        "_" + side + ".wav";
+    if (irL == nullptr || irR == nullptr)
+        return false;
 
-    auto it = hrirCache.find(originalFilename);
-    if (it == hrirCache.end())
-    {
-        DBG("HRIR not in cache: " + originalFilename);
+    // Both ears of a bank have the same length (truncated together)
+    engine.setFilter (slot, irL->getReadPointer (0), irR->getReadPointer (0),
+                      juce::jmin (irL->getNumSamples(), irR->getNumSamples()));
+    return true;
+}
+
+bool BinauralConvolver::getHrir (int azDeg, int elDeg, bool leftEar, juce::AudioBuffer<float>& ir) const
+{
+    if (! cacheBuilt)
         return false;
-    }
 
-    // Copy buffer (still not audio thread here). We move into convolver.
-    juce::AudioBuffer<float> ir = it->second;
+    // Same L/R swap as buildHrirGrid
+    const juce::String side = leftEar ? "R" : "L";
 
-    conv.loadImpulseResponse (std::move(ir),
-                              fs,
-                              juce::dsp::Convolution::Stereo::no,
-                              juce::dsp::Convolution::Trim::no,
-                              juce::dsp::Convolution::Normalise::no);
+    auto it = hrirCache.find ("azi_" + juce::String (azDeg) + "_ele_" + juce::String (elDeg) + "_" + side + ".wav");
+    if (it == hrirCache.end())
+        return false;
 
+    ir.makeCopyOf (it->second);
     return true;
 }
 
-bool BinauralConvolver::loadHrirPairFromCache (std::unique_ptr<juce::dsp::Convolution>& convL,
-                                               std::unique_ptr<juce::dsp::Convolution>& convR,
-                                               int azDeg, int elDeg)
+bool BinauralConvolver::loadCellIntoSlots (bool reduced, int azLower, int azUpper, int elLower, int elUpper,
+                                           unsigned keepSlots, CornerSlots& corners)
 {
-    if (! loadConvolverFromCache (*convL, azDeg, elDeg, true))  return false;
-    if (! loadConvolverFromCache (*convR, azDeg, elDeg, false)) return false;
+    const int cornerAz[4] = { azLower, azUpper, azUpper, azLower };
+    const int cornerEl[4] = { elLower, elLower, elUpper, elUpper };
+
+    unsigned usedSlots = keepSlots;
+    unsigned cellSlots = 0;
+
+    for (int k = 0; k < 4; ++k)
+    {
+        const int az = cornerAz[k];
+        const int el = cornerEl[k];
+        int found = -1;
+
+        // Shared with set A, or a repeated corner at the edge of the grid
+        for (int i = 0; i < numSlots && found < 0; ++i)
+            if (((keepSlots | cellSlots) & (1u << i)) != 0 && slots[(size_t) i].holds (az, el, reduced))
+                found = i;
+
+        // A free slot that still holds this direction: nothing to install
+        for (int i = 0; i < numSlots && found < 0; ++i)
+            if ((usedSlots & (1u << i)) == 0 && slots[(size_t) i].holds (az, el, reduced))
+                found = i;
+
+        if (found < 0)
+        {
+            for (int i = 0; i < numSlots && found < 0; ++i)
+                if ((usedSlots & (1u << i)) == 0)
+                    found = i;
+
+            jassert (found >= 0); // numSlots covers every audible state and set B with nothing shared
+
+            auto& slot = slots[(size_t) found];
+            slot.loaded = false;
+
+            if (! installHrirPair (reduced, found, az, el))
+                return false;
+
+            slot.azDeg = az;
+            slot.elDeg = el;
+            slot.reduced = reduced;
+            slot.loaded = true;
+        }
+
+        corners[(size_t) k] = found;
+        usedSlots |= 1u << found;
+        cellSlots |= 1u << found;
+    }
+
     return true;
 }
 
-bool BinauralConvolver::loadSetAFromCache (int azLower, int azUpper, int elLower, int elUpper)
+//==============================================================================
+// Bank truncation
+//==============================================================================
+
+int BinauralConvolver::findBankOnset (const HrirCache& bank, int preRollSamples)
+{
+    // Earliest sample within 30 dB of its IR's peak, over the whole bank. Shifting every IR
+    // by the same amount removes the common leading silence without touching the ITDs.
+    int onset = std::numeric_limits<int>::max();
+
+    for (const auto& entry : bank)
+    {
+        const auto& ir = entry.second;
+        const float* x = ir.getReadPointer (0);
+        const float threshold = ir.getMagnitude (0, 0, ir.getNumSamples()) * 0.0316f;
+
+        for (int i = 0; i < ir.getNumSamples() && i < onset; ++i)
+        {
+            if (std::abs (x[i]) >= threshold && threshold > 0.0f)
+            {
+                onset = i;
+                break;
+            }
+        }
+    }
+
+    if (onset == std::numeric_limits<int>::max())
+        return 0;
+
+    return juce::jmax (0, onset - preRollSamples);
+}
+
+BinauralConvolver::HrirCache BinauralConvolver::buildTruncatedBank (const HrirCache& full, int onset, int taps,
+                                                                   double sampleRate, HrirBankReport& report)
 {
-    bool ok = true;
-    ok &= loadHrirPairFromCache (convA_aL, convA_aR, azLower, elLower);
-    ok &= loadHrirPairFromCache (convA_bL, convA_bR, azUpper, elLower);
-    ok &= loadHrirPairFromCache (convA_cL, convA_cR, azUpper, elUpper);
-    ok &= loadHrirPairFromCache (convA_dL, convA_dR, azLower, elUpper);
-    return ok;
+    int fullTaps = 1;
+    for (const auto& entry : full)
+        fullTaps = juce::jmax (fullTaps, entry.second.getNumSamples());
+
+    const int available = juce::jmax (1, fullTaps - onset);
+    const int length = taps > 0 ? juce::jlimit (1, available, taps) : available;
+
+    // Half-Hann fade over the last quarter, only when something is actually cut off
+    const int fadeLength = length < available ? juce::jmax (1, length / 4) : 0;
+
+    // Spectral error against the full IR (magnitude only, so the onset shift is free)
+    const int fftOrder = juce::jmax (8, (int) std::ceil (std::log2 ((double) fullTaps)) + 1);
+    juce::dsp::FFT fft (fftOrder);
+    const int fftSize = fft.getSize();
+    std::vector<float> fullSpectrum ((size_t) fftSize * 2), truncSpectrum ((size_t) fftSize * 2);
+
+    const int binLow  = juce::jmax (1, juce::roundToInt (100.0 * fftSize / sampleRate));
+    const int binHigh = juce::jlimit (binLow + 1, fftSize / 2,
+                                      juce::roundToInt (juce::jmin (16000.0, sampleRate * 0.45) * fftSize / sampleRate));
+
+    HrirCache bank;
+    bank.reserve (full.size());
+
+    double errorSum = 0.0;
+    float errorMax = 0.0f;
+
+    for (const auto& entry : full)
+    {
+        const auto& src = entry.second;
+
+        juce::AudioBuffer<float> ir (1, length);
+        ir.clear();
+        ir.copyFrom (0, 0, src, 0, juce::jmin (onset, src.getNumSamples()),
+                     juce::jlimit (0, length, src.getNumSamples() - onset));
+
+        float* y = ir.getWritePointer (0);
+        for (int i = 0; i < fadeLength; ++i)
+            y[length - fadeLength + i] *= 0.5f * (1.0f + std::cos (juce::MathConstants<float>::pi * (float) (i + 1) / (float) fadeLength));
+
+        std::fill (fullSpectrum.begin(), fullSpectrum.end(), 0.0f);
+        std::fill (truncSpectrum.begin(), truncSpectrum.end(), 0.0f);
+        std::copy (src.getReadPointer (0), src.getReadPointer (0) + src.getNumSamples(), fullSpectrum.begin());
+        std::copy (y, y + length, truncSpectrum.begin());
+
+        fft.performFrequencyOnlyForwardTransform (fullSpectrum.data(), true);
+        fft.performFrequencyOnlyForwardTransform (truncSpectrum.data(), true);
+
+        float peak = 0.0f;
+        for (int bin = binLow; bin <= binHigh; ++bin)
+            peak = juce::jmax (peak, fullSpectrum[(size_t) bin]);
+
+        const float floor = peak * 1.0e-5f + 1.0e-12f;
+        double sumSq = 0.0;
+
+        for (int bin = binLow; bin <= binHigh; ++bin)
+        {
+            const double db = 20.0 * std::log10 ((truncSpectrum[(size_t) bin] + floor) / (fullSpectrum[(size_t) bin] + floor));
+            sumSq += db * db;
+        }
+
+        const auto rms = (float) std::sqrt (sumSq / (double) (binHigh - binLow + 1));
+        errorSum += rms;
+        errorMax = juce::jmax (errorMax, rms);
+
+        bank.emplace (entry.first, std::move (ir));
+    }
+
+    report.taps = length;
+    report.fullTaps = fullTaps;
+    report.onsetShift = onset;
+    report.meanSpectralErrorDb = full.empty() ? 0.0f : (float) (errorSum / (double) full.size());
+    report.maxSpectralErrorDb = errorMax;
+    report.memoryBytes = bank.size() * (size_t) length * sizeof (float);
+
+    return bank;
 }
 
-bool BinauralConvolver::loadSetBFromCache (int azLower, int azUpper, int elLower, int elUpper)
+//==============================================================================
+// Distance
+//==============================================================================
+
+void BinauralConvolver::setSourceLateral (float azDeg, float elDeg) noexcept
 {
-    bool ok = true;
-    ok &= loadHrirPairFromCache (convB_aL, convB_aR, azLower, elLower);
-    ok &= loadHrirPairFromCache (convB_bL, convB_bR, azUpper, elLower);
-    ok &= loadHrirPairFromCache (convB_cL, convB_cR, azUpper, elUpper);
-    ok &= loadHrirPairFromCache (convB_dL, convB_dR, azLower, elUpper);
-    return ok;
+    sourceLateral = std::sin (juce::degreesToRadians (azDeg)) * std::cos (juce::degreesToRadians (elDeg));
 }
 
 //==============================================================================
@@ -426,24 +798,190 @@ void BinauralConvolver::initialiseAtPositionDegrees (float azDeg, float elDeg)
     int azL, azU, elL, elU;
     float azF, elF;
 
+    listenerRotation.apply (azDeg, elDeg);
+    setSourceLateral (azDeg, elDeg);
+    azDeg = ListenerRotation::foldToFrontDegrees (azDeg);
+
     calculateGridPoints(azDeg, elDeg, azL, azU, azF, elL, elU, elF);
 
     // Synchronously load Set A (safe: called in prepareToPlay, not audio thread)
-    if (loadSetAFromCache(azL, azU, elL, elU))
+    const bool reduced = useReducedHrirs.load() && ! reducedHrirCache.empty();
+    auto& state = states[0];
+
+    if (loadCellIntoSlots (reduced, azL, azU, elL, elU, 0, state.corners))
+    {
+        state.reduced = reduced;
+        state.azLower = azL; state.azUpper = azU;
+        state.elLower = elL; state.elUpper = elU;
+        state.azFraction = azF;
+        state.elFraction = elF;
+        state.weightsPrev = BilinearWeights::fromFractions (azF, elF);
+        state.gain = 1.0f;
+        distancePrev = computeDistanceParams();
+        numStates = 1;
+        xfadeLeft = 0;
+        audibleSlots.store (slotMask (state.corners, allCorners), std::memory_order_release);
+
+        lastAzDeg = azDeg;
+        lastElDeg = elDeg;
+        hasLastPosition = true;
+    }
+}
+
+void BinauralConvolver::updateAngularSpeed (float azDeg, float elDeg) noexcept
+{
+    if (hasLastPosition)
+        travelledDegrees += std::sqrt ((azDeg - lastAzDeg) * (azDeg - lastAzDeg)
+                                       + (elDeg - lastElDeg) * (elDeg - lastElDeg));
+
+    lastAzDeg = azDeg;
+    lastElDeg = elDeg;
+    hasLastPosition = true;
+
+    // Several updates per chunk are summed until audio has run
+    if (samplesSincePosition > 0)
     {
-        aAzLower = azL; aAzUpper = azU;
-        aElLower = elL; aElUpper = elU;
-        aAzFraction = azF;
-        aElFraction = elF;
-        hasA = true;
+        const float speed = travelledDegrees / (float) samplesSincePosition;
+        degreesPerSample += 0.5f * (speed - degreesPerSample);
+        travelledDegrees = 0.0f;
+        samplesSincePosition = 0;
     }
 }
 
-void BinauralConvolver::beginCrossfadeToReadyB()
+int BinauralConvolver::getCrossfadeLength() const noexcept
 {
-    // B is ready, so we can begin audio-thread crossfade without loading anything.
-    switching = true;
-    xfadeLeft = xfadeTotal;
+    // Half the time a cell takes to cross: a steady sweep keeps about two states audible
+    const float cellDegrees = (float) juce::jmin (azimuthGridStep, elevationGridStep);
+    const float samples = 0.5f * cellDegrees / juce::jmax (degreesPerSample, 1.0e-9f);
+
+    return (int) juce::jlimit ((float) xfadeMinSamples, (float) xfadeMaxSamples, samples);
+}
+
+void BinauralConvolver::startTransitionToReadyB()
+{
+    // At the cap B waits for the fading states (the loader waits with it): CPU stays bounded
+    if (numStates >= maxAudibleStates)
+        return;
+
+    // Everything audible fades out from its current gain, all together over the new length
+    float fadingGain = 0.0f;
+    for (int i = 0; i < numStates - 1; ++i)
+        fadingGain += states[(size_t) i].gain;
+
+    if (numStates > 0)
+        currentState().gain = juce::jmax (0.0f, 1.0f - fadingGain);
+
+    auto& state = states[(size_t) numStates++];
+    state = incoming;
+
+    // B starts at its own weights (nothing to ramp from)
+    state.weightsPrev = BilinearWeights::fromFractions (state.azFraction, state.elFraction);
+    if (interpolation == Interpolation::nearestCorner)
+        state.weightsPrev = state.weightsPrev.nearestCorner();
+
+    xfadeLeft = numStates > 1 ? getCrossfadeLength() : 0;
+    reloadRequested = false;
+
+    unsigned mask = 0;
+    for (int i = 0; i < numStates; ++i)
+        mask |= slotMask (states[(size_t) i].corners, allCorners);
+
+    audibleSlots.store (mask, std::memory_order_relaxed);
+
+    // Request to first audible sample of the new cell (hasBReady was acquired by the caller)
+    if (auto* sink = telemetry.load (std::memory_order_relaxed))
+        sink->reportCrossfadeStarted (juce::Time::highResolutionTicksToSeconds (
+            juce::Time::getHighResolutionTicks() - bRequestTicks) * 1.0e6);
+
+    // Consume B (release: the loader reads the new audible slots after this)
+    hasBReady.store (false, std::memory_order_release);
+
+    if (pendingCell.load (std::memory_order_relaxed) != 0)
+        workerPool->notify(); // a newer request waited for B
+}
+
+void BinauralConvolver::dropFadedStates()
+{
+    if (numStates > 1)
+    {
+        states[0] = currentState();
+        numStates = 1;
+    }
+
+    states[0].gain = 1.0f;
+    xfadeLeft = 0;
+
+    // The slots only the faded states used become free for the loader
+    audibleSlots.store (slotMask (states[0].corners, allCorners), std::memory_order_release);
+}
+
+bool BinauralConvolver::jumpToPositionDegrees (float azDeg, float elDeg)
+{
+    if (! cacheBuilt || numStates == 0)
+    {
+        setPositionDegrees (azDeg, elDeg);
+        return true;
+    }
+
+    // Hold the loader off while slots are installed here (it never waits for us: a job that
+    // finds the flag taken is retried at the next poll)
+    bool idle = false;
+    if (! loaderBusy.compare_exchange_strong (idle, true, std::memory_order_acquire))
+        return false;
+
+    int azL, azU, elL, elU;
+    float azF, elF;
+
+    listenerRotation.apply (azDeg, elDeg);
+    setSourceLateral (azDeg, elDeg);
+    azDeg = ListenerRotation::foldToFrontDegrees (azDeg);
+
+    // A jump is not motion: restart the angular speed estimate
+    hasLastPosition = false;
+    travelledDegrees = 0.0f;
+    samplesSincePosition = 0;
+    degreesPerSample = 0.0f;
+    updateAngularSpeed (azDeg, elDeg);
+
+    calculateGridPoints (azDeg, elDeg, azL, azU, azF, elL, elU, elF);
+
+    // Nothing requested before the jump is wanted any more. A ready set B is dropped, so
+    // its slots are free along with the ones no audible state uses.
+    pendingCell.store (0);
+    hasBReady.store (false, std::memory_order_relaxed);
+
+    // The new cell goes into free slots (sharing what the audible states already hold), so
+    // the old states stay intact if the bank lacks a direction
+    const bool reduced = useReducedHrirs.load() && ! reducedHrirCache.empty();
+    CellState state;
+
+    if (loadCellIntoSlots (reduced, azL, azU, elL, elU, audibleSlots.load (std::memory_order_relaxed), state.corners))
+    {
+        state.reduced = reduced;
+        state.azLower = azL; state.azUpper = azU;
+        state.elLower = elL; state.elUpper = elU;
+        state.azFraction = azF;
+        state.elFraction = elF;
+        state.weightsPrev = BilinearWeights::fromFractions (azF, elF);
+        if (interpolation == Interpolation::nearestCorner)
+            state.weightsPrev = state.weightsPrev.nearestCorner();
+
+        // No fade from the stale states: the new cell is the only one audible from now on
+        states[0] = state;
+        numStates = 1;
+        dropFadedStates();
+
+        distancePrev = computeDistanceParams();
+        lastRequestedCell = packCell (azL, azU, elL, elU);
+        reloadRequested = false;
+    }
+
+    loaderBusy.store (false, std::memory_order_release);
+
+    if (pendingCell.load (std::memory_order_relaxed) != 0)
+        workerPool->notify(); // kept back by the jump
+
+    return true;
 }
 
 void BinauralConvolver::setPositionDegrees (float azDeg, float elDeg)
@@ -451,52 +989,117 @@ void BinauralConvolver::setPositionDegrees (float azDeg, float elDeg)
     int newAzLower, newAzUpper, newElLower, newElUpper;
     float newAzFraction, newElFraction;
 
+    listenerRotation.apply (azDeg, elDeg);
+    setSourceLateral (azDeg, elDeg);
+    azDeg = ListenerRotation::foldToFrontDegrees (azDeg);
+    updateAngularSpeed (azDeg, elDeg);
+
     calculateGridPoints (azDeg, elDeg,
                          newAzLower, newAzUpper, newAzFraction,
                          newElLower, newElUpper, newElFraction);
 
     // If not initialised (should be initialised in prepareToPlay), just update fractions safely.
-    if (!hasA)
+    if (numStates == 0)
     {
-        aAzLower = newAzLower; aAzUpper = newAzUpper;
-        aElLower = newElLower; aElUpper = newElUpper;
-        aAzFraction = newAzFraction;
-        aElFraction = newElFraction;
+        auto& state = states[0];
+        state.azLower = newAzLower; state.azUpper = newAzUpper;
+        state.elLower = newElLower; state.elUpper = newElUpper;
+        state.azFraction = newAzFraction;
+        state.elFraction = newElFraction;
         return;
     }
 
-    // Same grid region — update fractions only (cheap)
-    if (newAzLower == aAzLower && newAzUpper == aAzUpper &&
-        newElLower == aElLower && newElUpper == aElUpper)
+    // B is ready for this region: update its fractions (cheap)
+    if (hasBReady.load (std::memory_order_acquire)
+        && incoming.isCell (newAzLower, newAzUpper, newElLower, newElUpper))
     {
-        aAzFraction = newAzFraction;
-        aElFraction = newElFraction;
+        incoming.azFraction = newAzFraction;
+        incoming.elFraction = newElFraction;
+        incoming.prefetched = false; // the source got there: fade it in
+
+        // Back in the cell being faded in: drop a request for a cell left meanwhile
+        cancelPendingRequest();
+        lastRequestedCell = packCell (newAzLower, newAzUpper, newElLower, newElUpper);
         return;
     }
 
-    // If currently crossfading:
-    // - If B is ready and matches our new region, update B fractions (cheap)
-    // - Otherwise request new B load (background)
-    if (switching)
+    // Current cell — update fractions only (cheap). Fading states keep theirs.
+    auto& current = currentState();
+
+    if (current.isCell (newAzLower, newAzUpper, newElLower, newElUpper))
     {
-        if (hasBReady.load() &&
-            newAzLower == bAzLower && newAzUpper == bAzUpper &&
-            newElLower == bElLower && newElUpper == bElUpper)
-        {
-            bAzFraction = newAzFraction;
-            bElFraction = newElFraction;
-        }
-        else
+        current.azFraction = newAzFraction;
+        current.elFraction = newElFraction;
+
+        // Moved back before the cell last asked for became audible: neither it nor a pending
+        // request is needed any more (B's slots are not audible, the loader may reuse them).
+        // A bank reload dropped here is posted again by the next chunk.
+        const auto here = packCell (newAzLower, newAzUpper, newElLower, newElUpper);
+
+        if (lastRequestedCell != here)
         {
-            requestLoadSetB(newAzLower, newAzUpper, newElLower, newElUpper, newAzFraction, newElFraction);
+            cancelPendingRequest();
+            lastRequestedCell = here;
+            reloadRequested = false;
+
+            if (hasBReady.load (std::memory_order_relaxed) && ! incoming.prefetched)
+                hasBReady.store (false, std::memory_order_release);
         }
+
         return;
     }
 
-    // Not switching: request B load for new cell (background). Crossfade will start only when ready.
+    // A lookahead cell the source did not go to would hold the loader up
+    if (hasBReady.load (std::memory_order_relaxed) && incoming.prefetched)
+        hasBReady.store (false, std::memory_order_release);
+
+    // New cell: request a B load (background). Its crossfade starts when it is ready, from
+    // whatever mix of states is audible then.
     requestLoadSetB(newAzLower, newAzUpper, newElLower, newElUpper, newAzFraction, newElFraction);
 }
 
+bool BinauralConvolver::prefetchPositionDegrees (float azDeg, float elDeg)
+{
+    if (! cacheBuilt || numStates == 0)
+        return true;
+
+    int azL, azU, elL, elU;
+    float azF, elF;
+
+    // Same mapping as setPositionDegrees, without touching the rendered state
+    listenerRotation.apply (azDeg, elDeg);
+    azDeg = ListenerRotation::foldToFrontDegrees (azDeg);
+    calculateGridPoints (azDeg, elDeg, azL, azU, azF, elL, elU, elF);
+
+    if (currentState().isCell (azL, azU, elL, elU))
+        return false;
+
+    if (hasBReady.load (std::memory_order_acquire))
+    {
+        // Already waiting, or a switch the current position needs comes first
+        if (incoming.isCell (azL, azU, elL, elU) || ! incoming.prefetched)
+            return true;
+
+        // An earlier lookahead cell the source will not reach
+        hasBReady.store (false, std::memory_order_release);
+    }
+
+    const auto packed = packCell (azL, azU, elL, elU) | prefetchBit;
+    auto pending = pendingCell.load();
+
+    // A request for the current position is never displaced
+    if ((pending & cellMask) == packed || (pending != 0 && (pending & prefetchBit) == 0))
+        return true;
+
+    pendingRequestTicks.store (juce::Time::getHighResolutionTicks());
+
+    // (fails if the loader took the old one meanwhile: posted again on the next call)
+    if (pendingCell.compare_exchange_strong (pending, packed | packFractions (azF, elF), std::memory_order_release))
+        workerPool->notify();
+
+    return true;
+}
+
 //==============================================================================
 // Processing
 //==============================================================================
@@ -509,179 +1112,252 @@ void BinauralConvolver::ensureTempsCapacity (int numSamples)
             buf.setSize(2, numSamples, false, false, true);
     };
 
-    ensureStereo(tempA_a); ensureStereo(tempA_b);
-    ensureStereo(tempA_c); ensureStereo(tempA_d);
-    ensureStereo(tempB_a); ensureStereo(tempB_b);
-    ensureStereo(tempB_c); ensureStereo(tempB_d);
-    ensureStereo(tempA);   ensureStereo(tempB);
+    for (auto& slot : slots)
+        ensureStereo (slot.temp);
 
-    if (monoTempL.getNumChannels() != 1 || monoTempL.getNumSamples() < numSamples)
-        monoTempL.setSize(1, numSamples, false, false, true);
-
-    if (monoTempR.getNumChannels() != 1 || monoTempR.getNumSamples() < numSamples)
-        monoTempR.setSize(1, numSamples, false, false, true);
+    ensureStereo (fadeMix);
 }
 
-void BinauralConvolver::processConvolverPair (const juce::AudioBuffer<float>& monoIn,
-                                              juce::AudioBuffer<float>& stereoOut,
-                                              juce::dsp::Convolution& convL,
-                                              juce::dsp::Convolution& convR)
+void BinauralConvolver::processSlots (const float* monoIn, int numSamples,
+                                      unsigned processedSlots, unsigned activeSlots)
 {
-    const int N = monoIn.getNumSamples();
-
-    // Ensure output capacity (no realloc if already large enough)
-    if (stereoOut.getNumChannels() != 2 || stereoOut.getNumSamples() < N)
-        stereoOut.setSize(2, N, false, false, true);
+    float* outputs[numSlots * 2];
 
-    // Left ear
-    monoTempL.copyFrom(0, 0, monoIn, 0, 0, N);
+    for (int i = 0; i < numSlots; ++i)
     {
-        juce::dsp::AudioBlock<float> block(monoTempL);
-        juce::dsp::ProcessContextReplacing<float> ctx(block);
-        convL.process(ctx);
-    }
-    stereoOut.copyFrom(0, 0, monoTempL, 0, 0, N);
+        auto& slot = slots[(size_t) i];
+        outputs[2 * i]     = slot.temp.getWritePointer (0);
+        outputs[2 * i + 1] = slot.temp.getWritePointer (1);
 
-    // Right ear
-    monoTempR.copyFrom(0, 0, monoIn, 0, 0, N);
-    {
-        juce::dsp::AudioBlock<float> block(monoTempR);
-        juce::dsp::ProcessContextReplacing<float> ctx(block);
-        convR.process(ctx);
+        if ((activeSlots & ~processedSlots & (1u << i)) != 0)
+            slot.temp.clear (0, numSamples);
     }
-    stereoOut.copyFrom(1, 0, monoTempR, 0, 0, N);
+
+    // The engine reads monoIn once for all slots and writes straight into the corner
+    // buffers. It runs even when no slot does, to keep the input history current.
+    engine.process (monoIn, numSamples, processedSlots, outputs);
 }
 
-void BinauralConvolver::processBilinearSet (const juce::AudioBuffer<float>& monoIn,
-                                            juce::AudioBuffer<float>& stereoOut,
-                                            juce::dsp::Convolution& conv_aL, juce::dsp::Convolution& conv_aR,
-                                            juce::dsp::Convolution& conv_bL, juce::dsp::Convolution& conv_bR,
-                                            juce::dsp::Convolution& conv_cL, juce::dsp::Convolution& conv_cR,
-                                            juce::dsp::Convolution& conv_dL, juce::dsp::Convolution& conv_dR,
-                                            juce::AudioBuffer<float>& temp_a,
-                                            juce::AudioBuffer<float>& temp_b,
-                                            juce::AudioBuffer<float>& temp_c,
-                                            juce::AudioBuffer<float>& temp_d,
-                                            float azFrac, float elFrac)
+unsigned BinauralConvolver::slotMask (const CornerSlots& corners, unsigned cornerMask) noexcept
 {
-    const int N = monoIn.getNumSamples();
+    unsigned mask = 0;
 
-    // Process all 4 grid points
-    processConvolverPair (monoIn, temp_a, conv_aL, conv_aR);
-    processConvolverPair (monoIn, temp_b, conv_bL, conv_bR);
-    processConvolverPair (monoIn, temp_c, conv_cL, conv_cR);
-    processConvolverPair (monoIn, temp_d, conv_dL, conv_dR);
+    for (int k = 0; k < 4; ++k)
+        if ((cornerMask & (1u << k)) != 0)
+            mask |= 1u << corners[(size_t) k];
 
-    // Bilinear weights
-    const float w_a = (1.0f - azFrac) * (1.0f - elFrac);
-    const float w_b = azFrac * (1.0f - elFrac);
-    const float w_c = azFrac * elFrac;
-    const float w_d = (1.0f - azFrac) * elFrac;
+    return mask;
+}
 
-    if (stereoOut.getNumChannels() != 2 || stereoOut.getNumSamples() < N)
-        stereoOut.setSize(2, N, false, false, true);
+void BinauralConvolver::getCornerPointers (const CornerSlots& corners, int channel,
+                                           const float* (&pointers)[4]) const noexcept
+{
+    for (int k = 0; k < 4; ++k)
+        pointers[k] = slots[(size_t) corners[(size_t) k]].temp.getReadPointer (channel);
+}
 
-    for (int ch = 0; ch < 2; ++ch)
+void BinauralConvolver::processAndAdd (const float* monoIn, float* outL, float* outR, int numSamples)
+{
+    // Nothing loaded yet: contribute nothing
+    if (numStates == 0)
+        return;
+
+    // Oversized blocks are split so the temps sized in prepare() are always enough
+    for (int start = 0; start < numSamples; start += preparedBlockSize)
     {
-        const float* a = temp_a.getReadPointer(ch);
-        const float* b = temp_b.getReadPointer(ch);
-        const float* c = temp_c.getReadPointer(ch);
-        const float* d = temp_d.getReadPointer(ch);
-        float* out      = stereoOut.getWritePointer(ch);
+        const int n = juce::jmin (preparedBlockSize, numSamples - start);
+
+        // Idle once the input has been below -120 dBFS for a whole HRIR: their history
+        // holds nothing louder, so what the convolvers would still output is negligible
+        // and skipping them (and waking up on the next chunk above it) is click-free.
+        const auto range = juce::FloatVectorOperations::findMinAndMax (monoIn + start, n);
+        const bool silent = juce::jmax (-range.getStart(), range.getEnd()) <= silenceThreshold;
+        const bool tailDrained = silentSamples >= warmupSamples;
 
-        for (int n = 0; n < N; ++n)
-            out[n] = w_a * a[n] + w_b * b[n] + w_c * c[n] + w_d * d[n];
+        silentSamples = silent ? juce::jmin (silentSamples + n, warmupSamples) : 0;
+        samplesSincePosition = juce::jmin (samplesSincePosition + n, 1 << 30);
+
+        if (silent && tailDrained)
+            idleChunk();
+        else
+            processChunk (monoIn + start, outL + start, outR + start, n);
     }
 }
 
-void BinauralConvolver::process (const juce::AudioBuffer<float>& monoIn,
-                                 juce::AudioBuffer<float>& stereoOut)
+void BinauralConvolver::processChunk (const float* monoIn, float* outL, float* outR, int numSamples)
 {
-    const int N = monoIn.getNumSamples();
+    const int N = numSamples;
 
-    if (!hasA)
+    // If B finished loading in background, fade it in from the current mix now (safe &
+    // cheap on audio thread), even while earlier crossfades are still running. A lookahead
+    // cell waits until the position gets there.
+    if (hasBReady.load (std::memory_order_acquire) && ! incoming.prefetched)
+        startTransitionToReadyB();
+
+    // Bank changed (quality governor): reload the current cell, it crossfades in like a cell switch
+    auto& current = currentState();
+
+    if (numStates == 1 && !reloadRequested && current.reduced != (useReducedHrirs.load() && ! reducedHrirCache.empty()))
     {
-        stereoOut.setSize(2, N, false, false, true);
-        stereoOut.clear();
-        return;
+        reloadRequested = true;
+        lastRequestedCell = 0;
+        requestLoadSetB (current.azLower, current.azUpper, current.elLower, current.elUpper,
+                         current.azFraction, current.elFraction);
     }
 
-    ensureTempsCapacity(N);
+    const bool nearest = interpolation == Interpolation::nearestCorner;
 
-    // If B finished loading in background AND we are not currently switching,
-    // begin the crossfade now (safe & cheap on audio thread).
-    if (!switching && hasBReady.load())
+    // Only corners with weight in this chunk are convolved: the engine shares one input
+    // history between all slots, so a corner that was skipped is exact as soon as it runs.
+    // A slot shared by several states is convolved once.
+    WeightRamp ramps[maxAudibleStates];
+    unsigned activeSlots = 0, processedSlots = 0;
+
+    for (int i = 0; i < numStates; ++i)
     {
-        beginCrossfadeToReadyB();
+        auto& state = states[(size_t) i];
+
+        auto w = BilinearWeights::fromFractions (state.azFraction, state.elFraction);
+        if (nearest)
+            w = w.nearestCorner();
+
+        activeSlots    |= slotMask (state.corners, allCorners);
+        processedSlots |= slotMask (state.corners, state.weightsPrev.nonZeroMask() | w.nonZeroMask());
+
+        ramps[i] = makeWeightRamp (state.weightsPrev, w, N);
+        state.weightsPrev = w;
     }
 
-    // Process set A
-    processBilinearSet(monoIn, tempA,
-                       *convA_aL, *convA_aR,
-                       *convA_bL, *convA_bR,
-                       *convA_cL, *convA_cR,
-                       *convA_dL, *convA_dR,
-                       tempA_a, tempA_b, tempA_c, tempA_d,
-                       aAzFraction, aElFraction);
+    processSlots (monoIn, N, processedSlots, activeSlots);
+
+    float* const outs[2] = { outL, outR };
 
-    // If not crossfading, output A
-    if (!switching || !hasBReady.load())
+    // Distance stage: skipped entirely (vectorised mixes) at the 1 m identity
+    const auto distanceTarget = computeDistanceParams();
+    const bool withDistance = ! (distanceTarget.isIdentity() && distancePrev.isIdentity());
+
+    auto makeDistanceRamp = [&] (int ch)
     {
-        stereoOut.setSize(2, N, false, false, true);
-        stereoOut.copyFrom(0, 0, tempA, 0, 0, N);
-        stereoOut.copyFrom(1, 0, tempA, 1, 0, N);
-        return;
-    }
+        return DistanceModel::makeRamp (distancePrev, distanceTarget, ch, nearFieldShelfCoeff, N);
+    };
+
+    const int newest = numStates - 1;
 
-    // Process set B (already loaded)
-    processBilinearSet(monoIn, tempB,
-                       *convB_aL, *convB_aR,
-                       *convB_bL, *convB_bR,
-                       *convB_cL, *convB_cR,
-                       *convB_dL, *convB_dR,
-                       tempB_a, tempB_b, tempB_c, tempB_d,
-                       bAzFraction, bElFraction);
+    // If not crossfading, output the current cell
+    if (newest == 0)
+    {
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            const float* corners[4];
+            getCornerPointers (current.corners, ch, corners);
+
+            if (withDistance)
+            {
+                const auto ramp = makeDistanceRamp (ch);
+                DistanceModel::Stage stage (ramp, distanceState[(size_t) ch]);
+                mixBilinearRamp<true> (outs[ch], corners, ramps[0], N, &stage);
+                distanceState[(size_t) ch] = stage.getState();
+            }
+            else
+            {
+                mixBilinearRamp<false> (outs[ch], corners, ramps[0], N);
+            }
+        }
 
-    // Crossfade A → B (pointer-based, faster)
-    stereoOut.setSize(2, N, false, false, true);
+        distancePrev = distanceTarget;
+        return;
+    }
 
-    auto* outL = stereoOut.getWritePointer(0);
-    auto* outR = stereoOut.getWritePointer(1);
+    // The older states fade out together, so their combined gain falls linearly to zero
+    // over xfadeLeft and each keeps a constant share of it
+    float fadingGain = 0.0f;
+    for (int i = 0; i < newest; ++i)
+        fadingGain += states[(size_t) i].gain;
 
-    const auto* aL = tempA.getReadPointer(0);
-    const auto* aR = tempA.getReadPointer(1);
-    const auto* bL = tempB.getReadPointer(0);
-    const auto* bR = tempB.getReadPointer(1);
+    const float gainStep = fadingGain / (float) juce::jmax (1, xfadeLeft);
 
-    for (int n = 0; n < N; ++n)
+    // Crossfade fading -> newest fused with the bilinear mixes
+    for (int ch = 0; ch < 2; ++ch)
     {
-        const float t  = 1.0f - (float) xfadeLeft / (float) xfadeTotal;
-        const float gA = 1.0f - t;
-        const float gB = t;
+        const float* cornersA[4];
+        const float* cornersB[4];
+        WeightRamp rampA = ramps[0];
+        getCornerPointers (current.corners, ch, cornersB);
 
-        outL[n] = gA * aL[n] + gB * bL[n];
-        outR[n] = gA * aR[n] + gB * bR[n];
+        if (newest == 1)
+        {
+            getCornerPointers (states[0].corners, ch, cornersA);
+        }
+        else
+        {
+            // Merge the older states by their share, then fade the merged signal as one corner
+            float* merged = fadeMix.getWritePointer (ch);
+            juce::FloatVectorOperations::clear (merged, N);
+
+            for (int i = 0; i < newest; ++i)
+            {
+                const float* corners[4];
+                getCornerPointers (states[(size_t) i].corners, ch, corners);
+                mixBilinearRamp<false> (merged, corners,
+                                        scaledWeightRamp (ramps[i], states[(size_t) i].gain / juce::jmax (fadingGain, 1.0e-20f)), N);
+            }
+
+            for (auto& c : cornersA)
+                c = merged;
+
+            rampA = { { 1.0f, 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f, 0.0f } };
+        }
 
-        if (xfadeLeft > 0)
-            --xfadeLeft;
+        if (withDistance)
+        {
+            const auto ramp = makeDistanceRamp (ch);
+            DistanceModel::Stage stage (ramp, distanceState[(size_t) ch]);
+            mixBilinearCrossfade<true> (outs[ch], cornersA, rampA, cornersB, ramps[newest],
+                                        fadingGain, gainStep, N, &stage);
+            distanceState[(size_t) ch] = stage.getState();
+        }
+        else
+        {
+            mixBilinearCrossfade<false> (outs[ch], cornersA, rampA, cornersB, ramps[newest],
+                                         fadingGain, gainStep, N);
+        }
     }
 
-    // Crossfade complete — swap B → A
+    distancePrev = distanceTarget;
+
+    // Advance the fades; once they are complete only the newest state stays audible
+    const int faded = juce::jmin (N, xfadeLeft);
+    const float remaining = xfadeLeft > 0 ? (float) (xfadeLeft - faded) / (float) xfadeLeft : 0.0f;
+
+    for (int i = 0; i < newest; ++i)
+        states[(size_t) i].gain *= remaining;
+
+    xfadeLeft -= faded;
+
     if (xfadeLeft <= 0)
-    {
-        std::swap (convA_aL, convB_aL); std::swap (convA_aR, convB_aR);
-        std::swap (convA_bL, convB_bL); std::swap (convA_bR, convB_bR);
-        std::swap (convA_cL, convB_cL); std::swap (convA_cR, convB_cR);
-        std::swap (convA_dL, convB_dL); std::swap (convA_dR, convB_dR);
+        dropFadedStates();
+}
 
-        aAzLower = bAzLower; aAzUpper = bAzUpper;
-        aElLower = bElLower; aElUpper = bElUpper;
-        aAzFraction = bAzFraction;
-        aElFraction = bElFraction;
+void BinauralConvolver::idleChunk()
+{
+    // Output is silent whatever the IRs are, so pending switches complete at once
+    // (the input history all slots share is silent, so the new state wakes up clean)
+    if (numStates > 1)
+        dropFadedStates();
 
-        // Consume B
-        hasBReady.store(false);
-        switching = false;
-        xfadeLeft = 0;
+    if (hasBReady.load (std::memory_order_acquire) && ! incoming.prefetched)
+    {
+        startTransitionToReadyB();
+        dropFadedStates();
     }
+
+    // Jump the weights and the distance stage to where the source is now (nothing to ramp
+    // in silence); the filter states have decayed long before the HRIR tail has
+    distancePrev = computeDistanceParams();
+    distanceState = {};
+
+    auto& current = currentState();
+    current.weightsPrev = BilinearWeights::fromFractions (current.azFraction, current.elFraction);
+    if (interpolation == Interpolation::nearestCorner)
+        current.weightsPrev = current.weightsPrev.nearestCorner();
 }
@@ -1,22 +1,40 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <array>
 #include <atomic>
 #include <unordered_map>
+#include "DistanceModel.h"
+#include "EngineTelemetry.h"
+#include "ListenerRotation.h"
+#include "EngineWorkerPool.h"
+#include "PartitionedConvolver.h"
 
 /**
     BinauralConvolver
     - Bilinear interpolation across azimuth/elevation by mixing outputs of 4 convolvers (a,b,c,d).
-    - Uses two sets (A/B) for crossfading when grid cell changes.
+    - Cell changes crossfade through a small ring of audible cell states: a new cell fades in
+      from the current mix, even while earlier crossfades are still running, so fast motion
+      neither skips cells nor waits for a fade to finish. Convolvers belong to grid
+      directions rather than to cells: corners that audible cells share are convolved once.
     - HRIR WAVs are embedded via BinaryData.
-    - IMPORTANT: All WAV decode + Convolution::loadImpulseResponse happens OFF the audio thread.
+    - IMPORTANT: All WAV decoding and filter installation happen OFF the audio thread. Filters
+      are installed by the engine itself (PartitionedConvolver), so a set is live the moment
+      the loader publishes it; nothing is queued behind the audio thread.
+    - The audio-thread entry points (setPositionDegrees, processAndAdd) never allocate and never
+      lock: requests are handed to the loader through atomics.
+    - Set loads run on the process-wide EngineWorkerPool, notified lock-free when a request
+      is posted; an instance owns no threads.
 */
-class BinauralConvolver
+class BinauralConvolver : private EngineWorkerPool::Client
 {
 public:
-    BinauralConvolver();
-    ~BinauralConvolver();
+    BinauralConvolver() = default;
+    ~BinauralConvolver() override;
 
+    // Not audio thread. Rebuilds only what depends on a changed setting: a repeated prepare
+    // with the same sample rate, block size and HRIR length keeps the bank and the loaded
+    // filters and costs about as much as reset().
     void prepare (double sampleRate, int maxBlockSize);
     void reset();
 
@@ -26,11 +44,95 @@ public:
     // Can be called from audio thread. This function NEVER decodes WAV and NEVER calls loadImpulseResponse.
     void setPositionDegrees (float azDeg, float elDeg);
 
-    // Audio-thread processing
-    void process (const juce::AudioBuffer<float>& monoIn,
-                  juce::AudioBuffer<float>& stereoOut);
+    // Lookahead: where the source will be a known time from now (audio thread). Its cell is
+    // loaded in the background at prefetch priority and held ready, not audible, until
+    // setPositionDegrees() enters it; the crossfade then starts at once. Never displaces a
+    // load the current position needs. Returns false if the position is in the current cell
+    // (nothing to load), so a caller can scan a trajectory for the next cell.
+    bool prefetchPositionDegrees (float azDeg, float elDeg);
+
+    // Transport jump (host locate or playback start). Audio thread: installs the cell of this
+    // position straight from the bank, without allocating, and drops every audible state,
+    // pending request and ready set B instead of crossfading from them. Returns false, with
+    // nothing changed, while a background load is running; call again at the next chunk.
+    bool jumpToPositionDegrees (float azDeg, float elDeg);
+
+    // Listener head orientation, applied to every position set afterwards (before the grid
+    // lookup). Directions that end up behind the head are folded to the front, the bank has
+    // no rear measurements. Audio thread safe; takes effect at the next setPositionDegrees.
+    void setListenerRotation (const ListenerRotation& r) noexcept { listenerRotation = r; }
+
+    // Offline rendering only (blocks): waits until the loader has consumed every request.
+    // Returns false on timeout.
+    bool waitForPendingLoad (int timeoutMs);
+
+    // Audio-thread processing (process-and-add).
+    // Reads numSamples from monoIn and ADDS the binaural result into outL/outR.
+    // monoIn must not alias outL/outR. Blocks larger than the prepared size are processed
+    // in prepared-size chunks, so this never reallocates.
+    void processAndAdd (const float* monoIn, float* outL, float* outR, int numSamples);
+
+    // Copy of one grid point's HRIR from the prepared bank (not audio thread).
+    // azDeg/elDeg must be on the grid. Returns false if the bank has no such point.
+    bool getHrir (int azDeg, int elDeg, bool leftEar, juce::AudioBuffer<float>& ir) const;
+
+    // Input samples that refill the engine's whole input history: after a pause, feeding
+    // the last this many input samples makes the output exact again (warm-up)
+    int getWarmUpLength() const noexcept { return engine.getHistoryLength(); }
+
+    // Length of the output tail after the input stops (longest HRIR of the bank)
+    double getTailLengthSeconds() const noexcept { return (warmupSamples > 0 ? warmupSamples : 200) / fs; }
+
+    // HRIR length in taps at 44.1 kHz (scaled with the sample rate), 0 = full length.
+    // Applied when the bank is built, so call before prepare(). Every IR of the bank is
+    // shifted by the bank-wide onset (relative timing and ITDs are kept) and, when
+    // truncated, faded out with a half-Hann window.
+    void setHrirLength (int tapsAt44k) noexcept { requestedHrirTaps = juce::jmax (0, tapsAt44k); }
+
+    // Cost/accuracy of the bank built by prepare(): spectral error against the full IRs,
+    // RMS over 100 Hz .. 16 kHz per IR, averaged / worst case over the bank.
+    struct HrirBankReport
+    {
+        int taps = 0;                  // per IR, at the engine sample rate
+        int fullTaps = 0;
+        int onsetShift = 0;            // leading samples removed from every IR
+        float meanSpectralErrorDb = 0.0f;
+        float maxSpectralErrorDb = 0.0f;
+        size_t memoryBytes = 0;
+    };
+
+    const HrirBankReport& getHrirBankReport() const noexcept        { return bankReport; }
+    const HrirBankReport& getReducedHrirBankReport() const noexcept { return reducedBankReport; }
+
+    // Quality governor: switch to the reduced (64 taps at 44.1 kHz) bank. Audio thread OK;
+    // the current cell is reloaded in the background and crossfaded like a cell switch.
+    bool hasReducedHrirBank() const noexcept { return ! reducedHrirCache.empty(); }
+    void setReducedHrirs (bool shouldUseReduced) noexcept { useReducedHrirs.store (shouldUseReduced); }
+
+    // Corner selection. nearestCorner convolves only the corner with the largest bilinear
+    // weight (about a quarter of the cost). Audio thread OK; transitions are smooth because
+    // the input history is shared by all corners, so a corner that was skipped is exact as
+    // soon as it runs again and its weight ramps in over one chunk.
+    enum class Interpolation { bilinear, nearestCorner };
+    void setInterpolation (Interpolation newMode) noexcept { interpolation = newMode; }
+    Interpolation getInterpolation() const noexcept        { return interpolation; }
+
+    // Source distance in metres; the HRIRs are far-field (1 m). Rendered in the output stage
+    // (DistanceModel) with no extra convolution, ramped per sample across each chunk from
+    // the distance of the previous call. Audio thread OK.
+    void setDistance (float metres) noexcept { distanceMetres = juce::jlimit (DistanceModel::minMetres, DistanceModel::maxMetres, metres); }
+
+    // Optional stats sink (owned by the caller, must outlive this convolver). Set before
+    // prepare(), or later from the thread that drives the convolver (nullptr detaches it).
+    void setTelemetry (EngineTelemetry* sink) noexcept { telemetry.store (sink, std::memory_order_release); }
 
 private:
+    // tools/benchmarks drives the private kernels directly
+    friend struct BinauralBenchmarkAccess;
+
+    // Shared worker threads (set loads)
+    juce::SharedResourcePointer<EngineWorkerPool> workerPool;
+
     // ===================== Config =====================
     int azimuthMin = -90;
     int azimuthMax =  90;
@@ -40,43 +142,131 @@ private:
     int elevationMax =  90;
     int elevationGridStep = 10;
 
-    // ===================== Convolution sets (A/B) =====================
-    // Set A
-    std::unique_ptr<juce::dsp::Convolution> convA_aL, convA_aR;
-    std::unique_ptr<juce::dsp::Convolution> convA_bL, convA_bR;
-    std::unique_ptr<juce::dsp::Convolution> convA_cL, convA_cR;
-    std::unique_ptr<juce::dsp::Convolution> convA_dL, convA_dR;
+    // ===================== Corner slots =====================
+    // Filters are tracked by grid direction, not by cell: a slot of the engine holds the L/R
+    // pair of one direction. Every cell state maps its corners (a, b, c, d) to slots, so a
+    // direction two cells share stays in its slot and is convolved once per chunk; a
+    // single-axis cell crossing installs and runs only the two new corners. Four slots per
+    // audible state plus four for the incoming cell (set B) cover every switch, including a
+    // bank change (no corner shared).
+    // The audible states' slots belong to the audio thread, which publishes them in
+    // audibleSlots. The loader writes only the other slots, and only while no set B is
+    // ready (see hasPendingJob); hasBReady is the release/acquire fence that makes a set's
+    // filters live.
+    static constexpr int maxAudibleStates = 3; // caps the convolutions of a fast sweep
+    static constexpr int numSlots = 4 * (maxAudibleStates + 1);
+
+    PartitionedConvolver engine;
+
+    struct CornerSlot
+    {
+        juce::AudioBuffer<float> temp;  // stereo output of the current chunk
+        int azDeg = 0, elDeg = 0;
+        bool reduced = false;           // loaded from the reduced bank
+        bool loaded = false;
+
+        bool holds (int az, int el, bool fromReduced) const noexcept
+        {
+            return loaded && azDeg == az && elDeg == el && reduced == fromReduced;
+        }
+    };
+
+    using CornerSlots = std::array<int, 4>; // slot index of corner a, b, c, d
+
+    std::array<CornerSlot, numSlots> slots;
+
+    // Bilinear corner weights (a, b, c, d). The fractions only change once per block,
+    // so the mix ramps from the weights used at the end of the previous block.
+    struct BilinearWeights
+    {
+        float a = 1.0f, b = 0.0f, c = 0.0f, d = 0.0f;
+
+        static BilinearWeights fromFractions (float azFrac, float elFrac) noexcept
+        {
+            return { (1.0f - azFrac) * (1.0f - elFrac),
+                     azFrac * (1.0f - elFrac),
+                     azFrac * elFrac,
+                     (1.0f - azFrac) * elFrac };
+        }
+
+        BilinearWeights nearestCorner() const noexcept
+        {
+            BilinearWeights w { 0.0f, 0.0f, 0.0f, 0.0f };
+
+            if (a >= b && a >= c && a >= d)  w.a = 1.0f;
+            else if (b >= c && b >= d)       w.b = 1.0f;
+            else if (c >= d)                 w.c = 1.0f;
+            else                             w.d = 1.0f;
+
+            return w;
+        }
+
+        // bit k set when corner k (a, b, c, d) contributes
+        unsigned nonZeroMask() const noexcept
+        {
+            return (a != 0.0f ? 1u : 0u) | (b != 0.0f ? 2u : 0u)
+                 | (c != 0.0f ? 4u : 0u) | (d != 0.0f ? 8u : 0u);
+        }
+    };
 
-    // Set B
-    std::unique_ptr<juce::dsp::Convolution> convB_aL, convB_aR;
-    std::unique_ptr<juce::dsp::Convolution> convB_bL, convB_bR;
-    std::unique_ptr<juce::dsp::Convolution> convB_cL, convB_cR;
-    std::unique_ptr<juce::dsp::Convolution> convB_dL, convB_dR;
+    static constexpr unsigned allCorners = 0xf;
 
-    bool hasA = false;
+    // One grid cell: its corner slots, bounds and fractions
+    struct CellState
+    {
+        CornerSlots corners { 0, 1, 2, 3 };
+        int azLower = 0, azUpper = 0, elLower = 0, elUpper = 0;
+        float azFraction = 0.0f, elFraction = 0.0f;
+        BilinearWeights weightsPrev;
+        bool reduced = false;   // loaded from the reduced bank
+        bool prefetched = false; // set B only: loaded ahead, waits for the position to get there
+        float gain = 1.0f;      // fading states: gain at the start of the next chunk
+
+        bool isCell (int azL, int azU, int elL, int elU) const noexcept
+        {
+            return azLower == azL && azUpper == azU && elLower == elL && elUpper == elU;
+        }
+    };
+
+    // Audible states, oldest first (audio thread). The newest is the current cell; the
+    // others fade out together and all reach zero after xfadeLeft samples, so the newest's
+    // gain is 1 minus theirs and a new cell can fade in from any mixed state.
+    std::array<CellState, maxAudibleStates> states;
+    int numStates = 0;
+    std::atomic<unsigned> audibleSlots { 0 }; // slots of the audible states (read by the loader)
+
+    // Set B: the incoming cell (written by the loader, read after hasBReady)
+    CellState incoming;
     std::atomic<bool> hasBReady { false };
-    bool switching = false;
 
-    // Set A state
-    int aAzLower = 0, aAzUpper = 0, aElLower = 0, aElUpper = 0;
-    float aAzFraction = 0.0f, aElFraction = 0.0f;
+    CellState& currentState() noexcept { return states[(size_t) (numStates - 1)]; }
+
+    Interpolation interpolation = Interpolation::bilinear;
+    ListenerRotation listenerRotation;
+    int warmupSamples = 0; // longest HRIR of the bank: output tail, silence detection
 
-    // Set B state (prepared by background thread)
-    int bAzLower = 0, bAzUpper = 0, bElLower = 0, bElUpper = 0;
-    float bAzFraction = 0.0f, bElFraction = 0.0f;
+    // Bit s set for the slot of every corner in cornerMask
+    static unsigned slotMask (const CornerSlots& corners, unsigned cornerMask) noexcept;
+    void getCornerPointers (const CornerSlots& corners, int channel, const float* (&pointers)[4]) const noexcept;
 
-    // Crossfade
-    int xfadeTotal = 0;
-    int xfadeLeft  = 0;
+    // Crossfade: the length adapts to the angular speed, about half the time the source
+    // takes to cross a cell, between xfadeMinSamples (5 ms) and xfadeMaxSamples (30 ms).
+    int xfadeMinSamples = 0;
+    int xfadeMaxSamples = 0;
+    int xfadeLeft = 0;
 
-    // ===================== Temp buffers (preallocated) =====================
-    // For 4 corners per set: each is stereo
-    juce::AudioBuffer<float> tempA_a, tempA_b, tempA_c, tempA_d;
-    juce::AudioBuffer<float> tempB_a, tempB_b, tempB_c, tempB_d;
-    juce::AudioBuffer<float> tempA, tempB;
+    juce::AudioBuffer<float> fadeMix; // older fading states merged (more than two audible)
 
-    // Mono temp buffers to avoid allocating inside processConvolverPair
-    juce::AudioBuffer<float> monoTempL, monoTempR;
+    // Angular speed (audio thread): distance moved between position updates over the
+    // samples processed in between, smoothed
+    float lastAzDeg = 0.0f, lastElDeg = 0.0f;
+    bool hasLastPosition = false;
+    float travelledDegrees = 0.0f;
+    int samplesSincePosition = 0;
+    float degreesPerSample = 0.0f;
+
+    void updateAngularSpeed (float azDeg, float elDeg) noexcept;
+    int getCrossfadeLength() const noexcept;
 
     // ===================== HRIR cache (decoded & resampled) =====================
     struct JuceStringHash
@@ -85,7 +275,29 @@ private:
     };
 
     // Key: original filename (e.g. "azi_-10_ele_-10_L.wav")
-    std::unordered_map<juce::String, juce::AudioBuffer<float>, JuceStringHash> hrirCache;
+    using HrirCache = std::unordered_map<juce::String, juce::AudioBuffer<float>, JuceStringHash>;
+    HrirCache hrirCache;
+    HrirCache reducedHrirCache; // empty unless shorter than hrirCache
+
+    // Bank entries by grid direction, so installs need no string lookups (they also run on the
+    // audio thread after a transport jump). Index (azIndex * numElevations + elIndex) * 2 + ear,
+    // ear 0 = left. Pointers into hrirCache / reducedHrirCache, rebuilt with them.
+    std::vector<const juce::AudioBuffer<float>*> hrirGrid, reducedHrirGrid;
+
+    std::vector<const juce::AudioBuffer<float>*> buildHrirGrid (const HrirCache& cache) const;
+    const juce::AudioBuffer<float>* findHrir (bool reduced, int azDeg, int elDeg, bool leftEar) const noexcept;
+
+    static constexpr int reducedHrirTapsAt44k = 64;
+    int requestedHrirTaps = 0;
+    int bankHrirTaps = 0;       // requestedHrirTaps the current bank was built with
+    HrirBankReport bankReport, reducedBankReport;
+
+    std::atomic<bool> useReducedHrirs { false };
+    bool reloadRequested = false; // audio thread: reload of the current cell with the other bank posted
+
+    static int findBankOnset (const HrirCache& bank, int preRollSamples);
+    static HrirCache buildTruncatedBank (const HrirCache& full, int onset, int taps, double sampleRate,
+                                         HrirBankReport& report);
 
     // Map original filename -> BinaryData symbol name (wav / wav2 / wav3...)
     std::unordered_map<juce::String, juce::String, JuceStringHash> originalToSymbol;
@@ -93,31 +305,52 @@ private:
     bool cacheBuilt = false;
     double fs = 48000.0;
 
-    // ===================== Background loader thread =====================
-    struct PendingRequest
-    {
-        int azLower = 0, azUpper = 0, elLower = 0, elUpper = 0;
-        float azFrac = 0.0f, elFrac = 0.0f;
-        bool valid = false;
-    };
+    // Decodes, resamples (to fs) and truncates the whole bank (prepare(), not audio thread)
+    void buildHrirBank();
+
+    // ===================== Background loader (EngineWorkerPool client) =====================
+    // The pending cell is packed into one word (4 x uint8 bounds + valid bit, plus
+    // prefetchBit for lookahead loads, plus the position's fractions in the cell so the
+    // loader never pairs a cell with another request's weights) so the audio thread can
+    // post it without a lock, then
+    // EngineWorkerPool::notify() (a counter, not WaitableEvent::signal, which takes a mutex).
+
+    static juce::uint64 packCell (int azLower, int azUpper, int elLower, int elUpper) noexcept;
+    static void unpackCell (juce::uint64 packed, int& azLower, int& azUpper, int& elLower, int& elUpper) noexcept;
 
-    juce::CriticalSection requestLock;
-    PendingRequest pending;
-    std::atomic<bool> threadShouldExit { false };
-    juce::WaitableEvent requestEvent;
+    static constexpr juce::uint64 prefetchBit = juce::uint64 (1) << 33;
+    static constexpr juce::uint64 cellMask = (juce::uint64 (1) << 34) - 1; // cell + prefetchBit
 
-    std::unique_ptr<juce::Thread> loaderThread;
+    // Bits 34..63: azimuth and elevation fraction, 15 bits each
+    static juce::uint64 packFractions (float azFrac, float elFrac) noexcept;
+    static void unpackFractions (juce::uint64 packed, float& azFrac, float& elFrac) noexcept;
 
-    void startLoaderThread();
-    void stopLoaderThread();
-    void loaderThreadMain();
+    std::atomic<juce::uint64> pendingCell { 0 };
+    juce::uint64 lastRequestedCell = 0; // audio thread only: avoids re-posting the same cell
+    std::atomic<juce::int64> pendingRequestTicks { 0 }; // when the pending cell was posted (load latency)
+    juce::int64 bRequestTicks = 0; // request time of set B (published with hasBReady)
+
+    std::atomic<EngineTelemetry*> telemetry { nullptr }; // also read by the loader
+
+    std::atomic<bool> loaderBusy { false }; // also taken by jumpToPositionDegrees()
+    bool loaderRegistered = false;
+
+    bool hasPendingJob (EngineWorkerPool::Priority& priority) const noexcept override;
+    void runPendingJob() override;
 
     void requestLoadSetB (int azLower, int azUpper, int elLower, int elUpper,
                           float azFrac, float elFrac);
 
+    // Drops a pending request for the current position; a pending prefetch stays
+    void cancelPendingRequest() noexcept;
+
     // ===================== Internal helpers =====================
+    int preparedBlockSize = 0;
+
     void ensureTempsCapacity (int numSamples);
 
+    void processChunk (const float* monoIn, float* outL, float* outR, int numSamples);
+
     void calculateGridPoints (float azDeg, float elDeg,
                               int& azLower, int& azUpper, float& azFraction,
                               int& elLower, int& elUpper, float& elFraction) const;
@@ -134,34 +367,46 @@ private:
                                            double inSR,
                                            double outSR);
 
-    // Load a single convolver from cache (NOT audio thread)
-    bool loadConvolverFromCache (juce::dsp::Convolution& conv,
-                                 int azDeg, int elDeg, bool leftEar);
+    // Installs one direction's HRIR pair from the bank into an engine slot. Does not allocate;
+    // runs on the loader, or on the audio thread with the loader held off (transport jump).
+    bool installHrirPair (bool reduced, int slot, int azDeg, int elDeg);
 
-    bool loadHrirPairFromCache (std::unique_ptr<juce::dsp::Convolution>& convL,
-                                std::unique_ptr<juce::dsp::Convolution>& convR,
-                                int azDeg, int elDeg);
-
-    bool loadSetAFromCache (int azLower, int azUpper, int elLower, int elUpper);
-    bool loadSetBFromCache (int azLower, int azUpper, int elLower, int elUpper);
+    // Maps the cell's corners to slots. A direction held by a slot in keepSlots (or by an
+    // earlier corner of the cell) is shared; any other goes to a slot outside keepSlots,
+    // reusing a free slot that still holds it before installing a new filter.
+    bool loadCellIntoSlots (bool reduced, int azLower, int azUpper, int elLower, int elUpper,
+                            unsigned keepSlots, CornerSlots& corners);
 
     // Processing kernels
-    void processConvolverPair (const juce::AudioBuffer<float>& monoIn,
-                               juce::AudioBuffer<float>& stereoOut,
-                               juce::dsp::Convolution& convL,
-                               juce::dsp::Convolution& convR);
-
-    void processBilinearSet (const juce::AudioBuffer<float>& monoIn,
-                             juce::AudioBuffer<float>& stereoOut,
-                             juce::dsp::Convolution& conv_aL, juce::dsp::Convolution& conv_aR,
-                             juce::dsp::Convolution& conv_bL, juce::dsp::Convolution& conv_bR,
-                             juce::dsp::Convolution& conv_cL, juce::dsp::Convolution& conv_cR,
-                             juce::dsp::Convolution& conv_dL, juce::dsp::Convolution& conv_dR,
-                             juce::AudioBuffer<float>& temp_a,
-                             juce::AudioBuffer<float>& temp_b,
-                             juce::AudioBuffer<float>& temp_c,
-                             juce::AudioBuffer<float>& temp_d,
-                             float azFrac, float elFrac);
-
-    void beginCrossfadeToReadyB();
+    // Runs the convolutions of the slots in processedSlots into their temps (mixing is
+    // done by the fused kernel in processChunk(), one pass over memory for all states).
+    // Active slots that are skipped get a cleared temp.
+    void processSlots (const float* monoIn, int numSamples, unsigned processedSlots, unsigned activeSlots);
+
+    // Makes set B the newest audible state and starts the fade from the current mix.
+    // At maxAudibleStates it waits (and the loader with it) until the fades finish.
+    void startTransitionToReadyB();
+    // Keeps only the newest state once the others have faded out
+    void dropFadedStates();
+
+    // ===================== Distance (fused into the output mix) =====================
+    float distanceMetres = 1.0f;
+    float sourceLateral = 0.0f; // head-relative, sin(az) cos(el): +1 = right ear axis
+    float nearFieldShelfCoeff = 0.0f;
+    DistanceModel::Params distancePrev;
+    std::array<DistanceModel::State, 2> distanceState {};
+
+    DistanceModel::Params computeDistanceParams() const noexcept
+    {
+        return DistanceModel::computeParams (distanceMetres, sourceLateral, fs);
+    }
+
+    void setSourceLateral (float azDeg, float elDeg) noexcept;
+
+    // ===================== Silence detection =====================
+    // Consecutive input samples at or below silenceThreshold (saturates at one HRIR length)
+    static constexpr float silenceThreshold = 1.0e-6f; // -120 dBFS
+    int silentSamples = 0;
+
+    void idleChunk();
 };
@@ -0,0 +1,49 @@
+#include "DistanceModel.h"
+
+DistanceModel::Params DistanceModel::computeParams (float metres, float lateral, double sampleRate) noexcept
+{
+    Params p;
+    const float d = metres;
+
+    if (d == 1.0f)
+        return p;
+
+    p.gain = 1.0f / d;
+
+    // Air absorption relative to the 1 m reference: a one-pole whose loss at 10 kHz matches
+    // airAbsorptionDbPerMetreAt10k over the extra path, |H|^2 = 1 / (1 + (f / fc)^2)
+    if (d > 1.0f)
+    {
+        const float excess = std::pow (10.0f, airAbsorptionDbPerMetreAt10k * (d - 1.0f) * 0.1f) - 1.0f;
+        const float fc = 10000.0f / std::sqrt (excess);
+
+        if (fc < 0.45f * (float) sampleRate)
+            p.air = 1.0f - std::exp (-juce::MathConstants<float>::twoPi * fc / (float) sampleRate);
+    }
+
+    // Near field: each ear sits headRadius off the centre, so close sources reach the near ear
+    // louder and the far ear quieter than 1/d predicts. The far-field filters already hold
+    // the ratio at 1 m; only the excess is added, below the shelf.
+    if (d < 1.0f)
+    {
+        auto earDistance = [] (float dist, float towardsEar)
+        {
+            return std::sqrt (dist * dist + headRadiusMetres * headRadiusMetres
+                              - 2.0f * headRadiusMetres * dist * towardsEar);
+        };
+
+        for (int ear = 0; ear < 2; ++ear)
+        {
+            const float towardsEar = ear == 0 ? -lateral : lateral;
+            p.nearLf[ear] = earDistance (1.0f, towardsEar) * d / earDistance (d, towardsEar) - 1.0f;
+        }
+    }
+
+    return p;
+}
+
+float DistanceModel::shelfCoefficient (double sampleRate) noexcept
+{
+    const double shelfHz = speedOfSound / (juce::MathConstants<double>::pi * headRadiusMetres);
+    return (float) (1.0 - std::exp (-juce::MathConstants<double>::twoPi * shelfHz / sampleRate));
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    DistanceModel
+    - Source distance for renderers whose directional filters are far-field (1 m):
+      inverse-distance gain, an air-absorption low-pass beyond 1 m and, inside 1 m, a
+      per-ear low shelf for the near-field ILD. No extra convolution.
+    - Shared by BinauralConvolver and SphericalHeadModel, so both engines (and the
+      governor's crossfade between them) place a source at the same distance.
+    - Per ear: y = gain * (lp + nearLf * shelf(lp)), lp = one-pole air absorption,
+      shelf = fixed one-pole low-pass at the head's ka ~ 2 (below it the far-field HRIR
+      has almost no ILD, so that is where the near-field excess is missing).
+*/
+struct DistanceModel
+{
+    // The range of the "distance" parameter; setters clamp to it
+    static constexpr float minMetres = 0.2f;
+    static constexpr float maxMetres = 20.0f;
+
+    static constexpr float headRadiusMetres = 0.0875f;
+    static constexpr float speedOfSound     = 343.0f;
+    static constexpr float airAbsorptionDbPerMetreAt10k = 0.15f; // ISO 9613-1, 20 C, 50 % RH
+
+    struct Params
+    {
+        float gain = 1.0f;
+        float air = 1.0f;                   // one-pole coefficient, 1 = bypass
+        float nearLf[2] { 0.0f, 0.0f };     // low-shelf gain - 1, per ear (L, R)
+
+        bool isIdentity() const noexcept
+        {
+            return gain == 1.0f && air == 1.0f && nearLf[0] == 0.0f && nearLf[1] == 0.0f;
+        }
+    };
+
+    // lateral: head-relative sin(az) cos(el), +1 = right ear axis
+    static Params computeParams (float metres, float lateral, double sampleRate) noexcept;
+
+    // One-pole coefficient of the near-field shelf (corner at ka = 2, about 1.25 kHz)
+    static float shelfCoefficient (double sampleRate) noexcept;
+
+    // Coefficients ramp linearly from one Params to the next over a block (t = 1..N)
+    struct Ramp
+    {
+        float gain, gainStep;
+        float air, airStep;
+        float nearLf, nearLfStep;
+        float shelf;
+    };
+
+    static Ramp makeRamp (const Params& from, const Params& to, int ear, float shelfCoeff, int numSamples) noexcept
+    {
+        const float inv = 1.0f / (float) juce::jmax (1, numSamples);
+        return { from.gain, (to.gain - from.gain) * inv,
+                 from.air, (to.air - from.air) * inv,
+                 from.nearLf[ear], (to.nearLf[ear] - from.nearLf[ear]) * inv,
+                 shelfCoeff };
+    }
+
+    // Filter states of one ear, carried between blocks
+    struct State
+    {
+        float air = 0.0f, shelf = 0.0f;
+    };
+
+    // One ear for the length of a block: the states are kept in registers through the loop
+    struct Stage
+    {
+        const Ramp& r;
+        float lp, sh;
+
+        Stage (const Ramp& ramp, const State& s) noexcept : r (ramp), lp (s.air), sh (s.shelf) {}
+
+        float process (float x, float t) noexcept
+        {
+            lp += (r.air + t * r.airStep) * (x - lp);
+            sh += r.shelf * (lp - sh);
+            return (r.gain + t * r.gainStep) * (lp + (r.nearLf + t * r.nearLfStep) * sh);
+        }
+
+        State getState() const noexcept { return { lp, sh }; }
+    };
+};
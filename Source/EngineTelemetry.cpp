@@ -0,0 +1,234 @@
+#include "EngineTelemetry.h"
+
+//==============================================================================
+// One collector thread for the whole process, however many instances exist
+class TelemetryCollector final : private juce::Thread
+{
+public:
+    TelemetryCollector() : juce::Thread ("BinauralTelemetry")
+    {
+        startThread (juce::Thread::Priority::background);
+    }
+
+    ~TelemetryCollector() override
+    {
+        stopThread (2000);
+    }
+
+    void add (EngineTelemetry* t)
+    {
+        const juce::ScopedLock sl (lock);
+        instances.addIfNotAlreadyThere (t);
+    }
+
+    void remove (EngineTelemetry* t)
+    {
+        const juce::ScopedLock sl (lock); // also waits for a collect() in progress
+        instances.removeFirstMatchingValue (t);
+    }
+
+private:
+    static constexpr int intervalMs = 100;
+
+    juce::CriticalSection lock;
+    juce::Array<EngineTelemetry*> instances;
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            wait (intervalMs);
+
+            const juce::ScopedLock sl (lock);
+
+            for (auto* t : instances)
+                t->collect();
+        }
+    }
+};
+
+//==============================================================================
+void EngineTelemetry::Histogram::add (double microseconds) noexcept
+{
+    int bin = 0;
+
+    if (microseconds >= 1.0)
+        bin = juce::jmin (numBins - 1, 1 + (int) std::floor (std::log2 (microseconds)));
+
+    ++counts[(size_t) bin];
+    ++total;
+}
+
+double EngineTelemetry::Histogram::percentileMicroseconds (double p) const noexcept
+{
+    if (total == 0)
+        return 0.0;
+
+    const auto target = (juce::uint64) std::ceil (juce::jlimit (0.0, 1.0, p) * (double) total);
+    juce::uint64 running = 0;
+
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        running += counts[(size_t) bin];
+
+        if (running >= target)
+            return std::ldexp (1.0, bin);
+    }
+
+    return std::ldexp (1.0, numBins - 1);
+}
+
+//==============================================================================
+EngineTelemetry::EngineTelemetry()
+{
+    collector->add (this);
+}
+
+EngineTelemetry::~EngineTelemetry()
+{
+    collector->remove (this);
+}
+
+void EngineTelemetry::push (EventType type, float value, float aux) noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+    if (size1 + size2 == 0)
+    {
+        droppedEvents.fetch_add (1, std::memory_order_relaxed);
+        return;
+    }
+
+    ring[(size_t) (size1 > 0 ? start1 : start2)] = { type, value, aux };
+    fifo.finishedWrite (1);
+}
+
+void EngineTelemetry::reportBlock (double microseconds, double budgetMicroseconds) noexcept
+{
+    push (EventType::block, (float) microseconds, (float) budgetMicroseconds);
+}
+
+void EngineTelemetry::reportCellSwitchRequest (bool supersededPending) noexcept
+{
+    push (EventType::cellSwitchRequest);
+
+    if (supersededPending)
+        push (EventType::supersededRequest);
+}
+
+void EngineTelemetry::reportCrossfadeStarted (double requestToAudibleMicroseconds) noexcept
+{
+    push (EventType::crossfade, (float) requestToAudibleMicroseconds);
+}
+
+void EngineTelemetry::reportQualityLevel (int level) noexcept
+{
+    push (EventType::qualityLevel, (float) level);
+}
+
+void EngineTelemetry::reportTrackerLatency (double microseconds) noexcept
+{
+    push (EventType::trackerLatency, (float) microseconds);
+}
+
+void EngineTelemetry::reportSetLoaded (double latencyMs)
+{
+    const juce::ScopedLock sl (snapshotLock);
+
+    ++snapshot.setsLoaded;
+    snapshot.loadLatency.add (latencyMs * 1000.0);
+    loadLatencySumMs += latencyMs;
+    snapshot.loadLatencyAverageMs = loadLatencySumMs / (double) snapshot.setsLoaded;
+    snapshot.loadLatencyMaxMs = juce::jmax (snapshot.loadLatencyMaxMs, latencyMs);
+}
+
+void EngineTelemetry::collect()
+{
+    const int numReady = fifo.getNumReady();
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead (numReady, start1, size1, start2, size2);
+
+    const juce::ScopedLock sl (snapshotLock);
+
+    double loadSum = 0.0, loadPeak = 0.0;
+    int numBlocks = 0;
+
+    auto consume = [&] (const Event& e)
+    {
+        switch (e.type)
+        {
+            case EventType::block:
+            {
+                snapshot.blockTime.add (e.value);
+                ++snapshot.blocks;
+
+                const double load = e.aux > 0.0f ? (double) e.value / (double) e.aux : 0.0;
+                loadSum += load;
+                loadPeak = juce::jmax (loadPeak, load);
+                ++numBlocks;
+                break;
+            }
+
+            case EventType::cellSwitchRequest:  ++snapshot.cellSwitchRequests; break;
+            case EventType::supersededRequest:  ++snapshot.supersededRequests; break;
+            case EventType::crossfade:
+                ++snapshot.crossfades;
+                snapshot.switchLatency.add (e.value);
+                break;
+
+            case EventType::qualityLevel:
+                snapshot.qualityLevel = (int) e.value;
+                ++snapshot.qualityLevelChanges;
+                break;
+
+            case EventType::trackerLatency:
+                snapshot.trackerLatency.add (e.value);
+                break;
+        }
+    };
+
+    for (int i = 0; i < size1; ++i) consume (ring[(size_t) (start1 + i)]);
+    for (int i = 0; i < size2; ++i) consume (ring[(size_t) (start2 + i)]);
+
+    fifo.finishedRead (size1 + size2);
+
+    if (numBlocks > 0)
+    {
+        snapshot.loadAverage = loadSum / numBlocks;
+        snapshot.loadPeak = loadPeak;
+        snapshot.loadPeakEver = juce::jmax (snapshot.loadPeakEver, loadPeak);
+    }
+
+    snapshot.droppedEvents = droppedEvents.load (std::memory_order_relaxed);
+}
+
+EngineTelemetry::Snapshot EngineTelemetry::getSnapshot() const
+{
+    const juce::ScopedLock sl (snapshotLock);
+    return snapshot;
+}
+
+void EngineTelemetry::reset()
+{
+    const juce::ScopedLock sl (snapshotLock);
+    snapshot = {};
+    loadLatencySumMs = 0.0;
+    droppedEvents.store (0);
+}
+
+juce::String EngineTelemetry::describe (const Snapshot& s)
+{
+    return "CPU " + juce::String (s.loadAverage * 100.0, 1) + "% (peak " + juce::String (s.loadPeak * 100.0, 1) + "%)"
+         + "  p99 " + juce::String (s.blockTime.percentileMicroseconds (0.99), 0) + " us"
+         + "\nswitches " + juce::String ((juce::int64) s.cellSwitchRequests)
+         + " (superseded " + juce::String ((juce::int64) s.supersededRequests) + ")"
+         + "  xfades " + juce::String ((juce::int64) s.crossfades)
+         + "\nload " + juce::String (s.loadLatencyAverageMs, 2) + " ms avg / "
+         + juce::String (s.loadLatencyMaxMs, 2) + " ms max"
+         + "  quality " + juce::String (s.qualityLevel)
+         + (s.trackerLatency.total > 0
+              ? "\ntracker p99 " + juce::String (s.trackerLatency.percentileMicroseconds (0.99) / 1000.0, 2) + " ms"
+              : juce::String());
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+/**
+    EngineTelemetry
+    - Per-instance real-time load statistics: block processing time, cell-switch requests,
+      superseded requests, set-B load latency (request -> hasBReady), crossfades, the
+      quality level chosen by the QualityGovernor and head-tracker latency (packet received
+      -> first sub-block rendered with it).
+    - The audio thread only pushes fixed-size events into a wait-free single-producer ring
+      (juce::AbstractFifo). If the ring is full the event is dropped and counted.
+    - Loader-side events are rare and come from background threads, so they are folded in
+      under a lock that the audio thread never touches.
+    - One process-wide collector thread drains every registered instance ~10 times per
+      second and aggregates into a Snapshot that any non-audio thread can read.
+*/
+class TelemetryCollector;
+
+class EngineTelemetry
+{
+public:
+    EngineTelemetry();
+    ~EngineTelemetry();
+
+    //==============================================================================
+    // Log2 histogram of microseconds: bin k holds values in [2^(k-1), 2^k) us, bin 0 < 1 us
+    struct Histogram
+    {
+        static constexpr int numBins = 24;
+        std::array<juce::uint64, numBins> counts {};
+        juce::uint64 total = 0;
+
+        void add (double microseconds) noexcept;
+        double percentileMicroseconds (double p) const noexcept; // upper edge of the bin
+    };
+
+    struct Snapshot
+    {
+        Histogram blockTime;            // processBlock duration
+        Histogram loadLatency;          // request -> set B ready
+        Histogram switchLatency;        // request -> new cell audible (crossfade start)
+        Histogram trackerLatency;       // tracker packet received -> rendered
+        juce::uint64 blocks = 0;
+        double loadAverage = 0.0;       // block time / block duration, mean over the last interval
+        double loadPeak = 0.0;          // max over the last interval
+        double loadPeakEver = 0.0;
+        juce::uint64 cellSwitchRequests = 0;
+        juce::uint64 supersededRequests = 0;
+        juce::uint64 setsLoaded = 0;
+        double loadLatencyAverageMs = 0.0;
+        double loadLatencyMaxMs = 0.0;
+        juce::uint64 crossfades = 0;
+        int qualityLevel = 0;           // QualityGovernor::Level, 0 = full
+        juce::uint64 qualityLevelChanges = 0;
+        juce::uint64 droppedEvents = 0;  // ring overflow
+    };
+
+    //==============================================================================
+    // Audio thread (wait-free)
+    void reportBlock (double microseconds, double budgetMicroseconds) noexcept;
+    void reportCellSwitchRequest (bool supersededPending) noexcept;
+    void reportCrossfadeStarted (double requestToAudibleMicroseconds) noexcept;
+    void reportQualityLevel (int level) noexcept;
+    void reportTrackerLatency (double microseconds) noexcept;
+
+    // Background threads
+    void reportSetLoaded (double latencyMs);
+
+    // Any non-audio thread
+    Snapshot getSnapshot() const;
+    void reset();
+
+    // Helper for formatting a one-line summary (editor, logs)
+    static juce::String describe (const Snapshot& s);
+
+private:
+    enum class EventType : juce::uint8
+    {
+        block,
+        cellSwitchRequest,
+        supersededRequest,
+        crossfade,
+        qualityLevel,
+        trackerLatency
+    };
+
+    struct Event
+    {
+        EventType type;
+        float value;
+        float aux;
+    };
+
+    static constexpr int ringCapacity = 4096;
+
+    juce::AbstractFifo fifo { ringCapacity };
+    std::array<Event, ringCapacity> ring;
+    std::atomic<juce::uint32> droppedEvents { 0 };
+
+    void push (EventType type, float value = 0.0f, float aux = 0.0f) noexcept;
+
+    // Collector side. Held for the instance's lifetime so the shared collector (and its
+    // thread) lives as long as any instance does.
+    friend class TelemetryCollector;
+    juce::SharedResourcePointer<TelemetryCollector> collector;
+    void collect();
+
+    mutable juce::CriticalSection snapshotLock;
+    Snapshot snapshot;
+    double loadLatencySumMs = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE (EngineTelemetry)
+};
@@ -0,0 +1,193 @@
+#include "EngineWorkerPool.h"
+
+//==============================================================================
+class EngineWorkerPool::Worker final : public juce::Thread
+{
+public:
+    Worker (EngineWorkerPool& p, int index)
+        : juce::Thread ("BinauralWorker " + juce::String (index)), pool (p) {}
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            if (! pool.runNextJob())
+                pool.waitForWork (*this);
+        }
+    }
+
+private:
+    EngineWorkerPool& pool;
+};
+
+//==============================================================================
+EngineWorkerPool::EngineWorkerPool()
+{
+    // Leave a core for the audio thread; loads are short and rare, so a few threads suffice
+    const int numThreads = juce::jlimit (1, maxThreads, juce::SystemStats::getNumCpus() - 1);
+
+    for (int i = 0; i < numThreads; ++i)
+        workers.add (new Worker (*this, i))->startThread (juce::Thread::Priority::normal);
+}
+
+EngineWorkerPool::~EngineWorkerPool()
+{
+    for (auto* w : workers)
+        w->signalThreadShouldExit();
+
+    // Idle workers sleep on the event, which wakes one of them per signal
+    for (auto* w : workers)
+        while (! w->waitForThreadToExit (1))
+            wakeEvent.signal();
+}
+
+void EngineWorkerPool::addClient (Client& client)
+{
+    const juce::ScopedLock sl (lock);
+
+    for (auto& e : clients)
+        if (e.client == &client)
+            return;
+
+    clients.add ({ &client, false });
+}
+
+void EngineWorkerPool::removeClient (Client& client)
+{
+    for (;;)
+    {
+        {
+            const juce::ScopedLock sl (lock);
+
+            int index = -1;
+            for (int i = 0; i < clients.size(); ++i)
+                if (clients.getReference (i).client == &client)
+                    index = i;
+
+            if (index < 0)
+                return;
+
+            if (! clients.getReference (index).running)
+            {
+                clients.remove (index);
+                return;
+            }
+        }
+
+        juce::Thread::sleep (1); // a worker is inside runPendingJob()
+    }
+}
+
+void EngineWorkerPool::addJob (Priority priority, std::function<void()> job)
+{
+    {
+        const juce::ScopedLock sl (lock);
+        jobs[(int) priority].push_back (std::move (job));
+    }
+
+    wakeEvent.signal();
+}
+
+void EngineWorkerPool::waitForWork (const juce::Thread& worker)
+{
+    bool expected = false;
+
+    if (! watching.compare_exchange_strong (expected, true))
+    {
+        wakeEvent.wait (-1.0); // another worker watches the clients
+        return;
+    }
+
+    while (! worker.threadShouldExit())
+    {
+        const int interval = watchIdleMs < idleBackOffMs ? pollIntervalMs : idlePollIntervalMs;
+
+        if (wakeEvent.wait (interval))
+            break; // a job was queued, or a busy worker has more
+
+        const auto serial = requestSerial.load (std::memory_order_acquire);
+
+        if (serial != watchedSerial)
+        {
+            watchedSerial = serial;
+            watchIdleMs = 0;
+            break;
+        }
+
+        watchIdleMs += interval;
+
+        if (interval == idlePollIntervalMs)
+            break;
+    }
+
+    watching.store (false); // taken again if the scan finds nothing
+}
+
+bool EngineWorkerPool::runNextJob()
+{
+    Client* client = nullptr;
+    std::function<void()> job;
+    bool moreWaiting = false;
+
+    {
+        const juce::ScopedLock sl (lock);
+
+        for (int p = 0; p < 2 && client == nullptr && ! job; ++p)
+        {
+            const auto priority = (Priority) p;
+
+            if (! jobs[p].empty())
+            {
+                job = std::move (jobs[p].front());
+                jobs[p].erase (jobs[p].begin());
+                break;
+            }
+
+            for (int i = 0; i < clients.size(); ++i)
+            {
+                const int index = (nextClient + i) % clients.size();
+                auto& e = clients.getReference (index);
+                Priority pending;
+
+                if (! e.running && e.client->hasPendingJob (pending) && pending == priority)
+                {
+                    e.running = true;
+                    client = e.client;
+                    nextClient = (index + 1) % clients.size();
+                    break;
+                }
+            }
+        }
+
+        moreWaiting = ! jobs[0].empty() || ! jobs[1].empty();
+
+        for (int i = 0; i < clients.size() && ! moreWaiting; ++i)
+        {
+            const auto& e = clients.getReference (i);
+            Priority pending;
+            moreWaiting = ! e.running && e.client->hasPendingJob (pending);
+        }
+    }
+
+    // Another worker takes the rest, or the watch while this one is busy
+    if (moreWaiting || ((job || client != nullptr) && ! watching.load()))
+        wakeEvent.signal();
+
+    if (job)
+    {
+        job();
+        return true;
+    }
+
+    if (client == nullptr)
+        return false;
+
+    client->runPendingJob();
+
+    const juce::ScopedLock sl (lock);
+    for (auto& e : clients)
+        if (e.client == client)
+            e.running = false;
+
+    return true;
+}
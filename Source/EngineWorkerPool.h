@@ -0,0 +1,96 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+
+/**
+    EngineWorkerPool
+    - One process-wide set of background threads for every engine instance: HRIR set loads
+      and any other deferred engine work. The thread count is fixed (at most maxThreads),
+      however many plugin instances exist. Hold it through juce::SharedResourcePointer.
+    - Work comes from two places:
+        * Clients (e.g. BinauralConvolver) whose requests are posted from the audio thread
+          through atomics, followed by notify(). Waking a thread takes a lock, so notify()
+          only bumps a counter: one idle worker watches it every pollIntervalMs (no lock,
+          no scan) and scans the clients when it moves. After idleBackOffMs without a
+          request the watch slows to idlePollIntervalMs, with a full scan each time in case
+          a client posted without notifying. The other idle workers sleep until woken.
+        * One-off jobs queued from non-audio threads; these wake a worker immediately.
+    - A worker that takes a job while more is waiting wakes another one.
+    - Priorities: work needed now (the cell being rendered) always runs before prefetches.
+      A client is never serviced by two workers at once, and clients of equal priority
+      are served round-robin.
+*/
+class EngineWorkerPool
+{
+public:
+    enum class Priority
+    {
+        now,        // needed for the current output
+        prefetch    // speculative, may be superseded
+    };
+
+    class Client
+    {
+    public:
+        virtual ~Client() = default;
+
+        // Called by the workers on every poll; must be cheap and lock-free.
+        // Returns true (and the priority) when a job is waiting.
+        virtual bool hasPendingJob (Priority& priority) const noexcept = 0;
+
+        // Runs the waiting job on a worker thread
+        virtual void runPendingJob() = 0;
+    };
+
+    EngineWorkerPool();
+    ~EngineWorkerPool();
+
+    // Not audio thread. removeClient() waits for a job of that client in progress.
+    void addClient (Client& client);
+    void removeClient (Client& client);
+
+    // Not audio thread
+    void addJob (Priority priority, std::function<void()> job);
+
+    // Audio thread OK (lock-free): a client has posted a request
+    void notify() noexcept { requestSerial.fetch_add (1, std::memory_order_release); }
+
+    int getNumThreads() const noexcept { return workers.size(); }
+
+    static constexpr int maxThreads = 4;
+    static constexpr int pollIntervalMs = 2;
+    static constexpr int idlePollIntervalMs = 20;
+    static constexpr int idleBackOffMs = 500;
+
+private:
+    class Worker;
+
+    struct ClientEntry
+    {
+        Client* client = nullptr;
+        bool running = false;
+    };
+
+    juce::CriticalSection lock;
+    juce::Array<ClientEntry> clients;
+    int nextClient = 0; // round-robin start
+
+    std::vector<std::function<void()>> jobs[2]; // per Priority
+
+    juce::WaitableEvent wakeEvent;
+    juce::OwnedArray<Worker> workers;
+
+    std::atomic<juce::uint32> requestSerial { 0 }; // notify()
+    std::atomic<bool> watching { false };           // an idle worker watches requestSerial
+    juce::uint32 watchedSerial = 0;                 // by the watching worker
+    int watchIdleMs = 0;                            // since requestSerial last moved
+
+    // Worker side: takes the most urgent job, or returns false when idle
+    bool runNextJob();
+    // Worker side, after runNextJob() found nothing: returns when there may be work
+    void waitForWork (const juce::Thread& worker);
+
+    JUCE_DECLARE_NON_COPYABLE (EngineWorkerPool)
+};
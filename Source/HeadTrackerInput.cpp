@@ -0,0 +1,302 @@
+#include "HeadTrackerInput.h"
+
+namespace
+{
+    // OSC strings are NUL-terminated and padded to 4 bytes
+    int oscStringLength (const char* data, int size) noexcept
+    {
+        for (int i = 0; i < size; ++i)
+            if (data[i] == 0)
+                return juce::jmin (size, (i + 4) & ~3);
+
+        return -1;
+    }
+
+    juce::uint32 readBigEndian32 (const char* p) noexcept
+    {
+        return juce::ByteOrder::bigEndianInt (p);
+    }
+}
+
+//==============================================================================
+// One socket and one thread for the process; instances subscribe and read its sequence lock
+class OscOrientationReceiver final : private juce::Thread
+{
+public:
+    OscOrientationReceiver() : juce::Thread ("Head tracker input") {}
+    ~OscOrientationReceiver() override { close(); }
+
+    bool subscribe (int udpPort)
+    {
+        const juce::ScopedLock sl (lock);
+
+        // Already bound where asked (or anywhere, for port 0)
+        if (socket == nullptr || (udpPort != 0 && udpPort != boundPort.load()))
+        {
+            auto s = std::make_unique<juce::DatagramSocket> (false);
+
+            if (! s->bindToPort (udpPort, "127.0.0.1"))
+                return false; // the current binding, if any, stays
+
+            close();
+            socket = std::move (s);
+            boundPort = socket->getBoundPort();
+            startThread (juce::Thread::Priority::high);
+        }
+
+        ++numSubscribers;
+        return true;
+    }
+
+    void unsubscribe()
+    {
+        const juce::ScopedLock sl (lock);
+
+        if (--numSubscribers == 0)
+            close();
+    }
+
+    int getBoundPort() const noexcept { return boundPort.load(); }
+
+    bool readLatest (juce::uint32& lastSequence, HeadTrackerInput::Orientation& orientation,
+                     juce::int64& receivedTicks) const noexcept
+    {
+        const auto s1 = sequence.load (std::memory_order_acquire);
+
+        if ((s1 & 1) != 0 || s1 == lastSequence)
+            return false;
+
+        HeadTrackerInput::Orientation o;
+        o.yawDeg   = yaw.load (std::memory_order_relaxed);
+        o.pitchDeg = pitch.load (std::memory_order_relaxed);
+        o.rollDeg  = roll.load (std::memory_order_relaxed);
+        const auto t = ticks.load (std::memory_order_relaxed);
+
+        std::atomic_thread_fence (std::memory_order_acquire);
+
+        if (sequence.load (std::memory_order_relaxed) != s1)
+            return false; // torn read, the next sub-block picks it up
+
+        lastSequence = s1;
+        orientation = o;
+        receivedTicks = t;
+        return true;
+    }
+
+private:
+    juce::CriticalSection lock; // subscriptions (message threads of all instances)
+    std::unique_ptr<juce::DatagramSocket> socket;
+    std::atomic<int> boundPort { 0 };
+    int numSubscribers = 0;
+
+    // Sequence lock, single writer (the receiver thread)
+    std::atomic<juce::uint32> sequence { 0 };
+    std::atomic<float> yaw { 0.0f }, pitch { 0.0f }, roll { 0.0f };
+    std::atomic<juce::int64> ticks { 0 };
+
+    void close()
+    {
+        if (socket == nullptr)
+            return;
+
+        signalThreadShouldExit();
+        socket->shutdown(); // wakes the blocking wait
+        stopThread (1000);
+
+        socket.reset();
+        boundPort = 0;
+    }
+
+    void run() override
+    {
+        char packet[1536];
+
+        while (! threadShouldExit())
+        {
+            if (socket->waitUntilReady (true, 100) != 1)
+                continue;
+
+            const int size = socket->read (packet, (int) sizeof (packet), false);
+            const auto receivedTicks = juce::Time::getHighResolutionTicks();
+
+            HeadTrackerInput::Orientation o;
+            if (size > 0 && HeadTrackerInput::parseOscPacket (packet, size, o))
+                publish (o, receivedTicks);
+        }
+    }
+
+    void publish (const HeadTrackerInput::Orientation& o, juce::int64 receivedTicks) noexcept
+    {
+        const auto s = sequence.load (std::memory_order_relaxed);
+        sequence.store (s + 1, std::memory_order_relaxed); // odd: write in progress
+        std::atomic_thread_fence (std::memory_order_release);
+
+        yaw.store (o.yawDeg, std::memory_order_relaxed);
+        pitch.store (o.pitchDeg, std::memory_order_relaxed);
+        roll.store (o.rollDeg, std::memory_order_relaxed);
+        ticks.store (receivedTicks, std::memory_order_relaxed);
+
+        sequence.store (s + 2, std::memory_order_release);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (OscOrientationReceiver)
+};
+
+//==============================================================================
+HeadTrackerInput::HeadTrackerInput() = default;
+
+HeadTrackerInput::~HeadTrackerInput()
+{
+    stopListening();
+}
+
+bool HeadTrackerInput::startListening (int udpPort)
+{
+    stopListening();
+
+    if (! receiver->subscribe (udpPort))
+        return false;
+
+    listening = true;
+    return true;
+}
+
+void HeadTrackerInput::stopListening()
+{
+    if (! listening.exchange (false))
+        return;
+
+    receiver->unsubscribe();
+}
+
+int HeadTrackerInput::getListeningPort() const noexcept
+{
+    return listening.load() ? receiver->getBoundPort() : 0;
+}
+
+bool HeadTrackerInput::readLatest (juce::uint32& lastSequence, Orientation& orientation,
+                                   juce::int64& receivedTicks) const noexcept
+{
+    return listening.load (std::memory_order_relaxed)
+        && receiver->readLatest (lastSequence, orientation, receivedTicks);
+}
+
+bool HeadTrackerInput::handleMidiMessage (const juce::MidiMessage& message) noexcept
+{
+    if (! message.isController())
+        return false;
+
+    const int cc = message.getControllerNumber();
+    const int value = message.getControllerValue();
+    int axis = -1;
+
+    if (cc >= firstMsbController && cc < firstMsbController + 3)
+    {
+        axis = cc - firstMsbController;
+        msb[axis] = value;
+        lsb[axis] = 0; // a new MSB resets the fine part, as in the MIDI spec
+    }
+    else if (cc >= firstLsbController && cc < firstLsbController + 3)
+    {
+        axis = cc - firstLsbController;
+        lsb[axis] = value;
+    }
+
+    if (axis < 0)
+        return false;
+
+    // 14-bit value centred on 8192 -> +-180 (yaw, roll) or +-90 (pitch) degrees
+    const float normalised = (float) ((msb[axis] << 7) | lsb[axis]) / 8192.0f - 1.0f;
+
+    switch (axis)
+    {
+        case 0:  midiOrientation.yawDeg   = normalised * 180.0f; break;
+        case 1:  midiOrientation.pitchDeg = normalised * 90.0f;  break;
+        default: midiOrientation.rollDeg  = normalised * 180.0f; break;
+    }
+
+    return true;
+}
+
+bool HeadTrackerInput::parseOscPacket (const void* data, int size, Orientation& orientation) noexcept
+{
+    const char* p = static_cast<const char*> (data);
+
+    if (size < 8 || (size & 3) != 0)
+        return false;
+
+    // Bundle: "#bundle", 8-byte time tag, then (int32 size, element) pairs
+    if (std::memcmp (p, "#bundle", 8) == 0)
+    {
+        bool found = false;
+
+        for (int pos = 16; pos + 4 <= size;)
+        {
+            const int elementSize = (int) readBigEndian32 (p + pos);
+            pos += 4;
+
+            if (elementSize <= 0 || pos + elementSize > size)
+                break;
+
+            found = parseOscPacket (p + pos, elementSize, orientation) || found;
+            pos += elementSize;
+        }
+
+        return found;
+    }
+
+    // Message: address ending in "/ypr", type tags, arguments
+    const int addressLength = oscStringLength (p, size);
+    if (addressLength <= 0)
+        return false;
+
+    const auto addressChars = std::strlen (p);
+    if (addressChars < 4 || std::memcmp (p + addressChars - 4, "/ypr", 4) != 0)
+        return false;
+
+    const char* tags = p + addressLength;
+    const int tagsLength = oscStringLength (tags, size - addressLength);
+    if (tagsLength <= 0 || tags[0] != ',')
+        return false;
+
+    const char* arg = tags + tagsLength;
+    const char* end = p + size;
+    float values[3];
+
+    for (int i = 0; i < 3; ++i)
+    {
+        const char tag = tags[i + 1];
+        const int bytes = tag == 'd' ? 8 : 4;
+
+        if (arg + bytes > end)
+            return false;
+
+        if (tag == 'f')
+        {
+            const auto bits = readBigEndian32 (arg);
+            std::memcpy (&values[i], &bits, sizeof (float));
+        }
+        else if (tag == 'i')
+        {
+            values[i] = (float) (juce::int32) readBigEndian32 (arg);
+        }
+        else if (tag == 'd')
+        {
+            const auto bits = juce::ByteOrder::bigEndianInt64 (arg);
+            double d;
+            std::memcpy (&d, &bits, sizeof (double));
+            values[i] = (float) d;
+        }
+        else
+        {
+            return false;
+        }
+
+        arg += bytes;
+    }
+
+    orientation.yawDeg   = values[0];
+    orientation.pitchDeg = values[1];
+    orientation.rollDeg  = values[2];
+    return true;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+/**
+    HeadTrackerInput
+    - Listener orientation from a head tracker: OSC over UDP on localhost and MIDI CC.
+    - OSC: one message ".../ypr" with three float/double/int arguments (yaw, pitch, roll
+      in degrees), alone or inside bundles. The receiver is process-wide (held through
+      juce::SharedResourcePointer): one socket and one thread serve every instance that
+      listens, so one tracker rotates the whole scene. Its thread blocks on the socket and
+      publishes every packet the moment it arrives, stamped with its receive time.
+    - The latest orientation is published through a sequence lock: the audio thread of each
+      listening instance reads it wait-free once per control-rate sub-block, and simply
+      retries on the next sub-block if it caught the writer mid-update.
+    - MIDI CC: 16/17/18 carry yaw/pitch/roll (MSB), 48/49/50 the optional 14-bit LSB.
+      The AU build stays an effect ('aufx') and gets no MIDI, so there it is OSC only.
+      Decoded on the audio thread at the event's sample position.
+*/
+class OscOrientationReceiver;
+
+class HeadTrackerInput
+{
+public:
+    static constexpr int defaultUdpPort = 9000;
+
+    struct Orientation
+    {
+        float yawDeg = 0.0f, pitchDeg = 0.0f, rollDeg = 0.0f;
+    };
+
+    HeadTrackerInput();
+    ~HeadTrackerInput();
+
+    // Message thread. Joins the shared receiver on 127.0.0.1:udpPort (0 = any free port).
+    // The first listener binds it; a listener asking for another port moves it there for
+    // every instance. False if the port is taken by another application.
+    bool startListening (int udpPort = defaultUdpPort);
+    void stopListening();
+    bool isListening() const noexcept { return listening.load(); }
+    int getListeningPort() const noexcept;
+
+    // Audio thread (wait-free). True when an orientation newer than lastSequence arrived;
+    // receivedTicks is its juce::Time::getHighResolutionTicks() at socket read.
+    bool readLatest (juce::uint32& lastSequence, Orientation& orientation, juce::int64& receivedTicks) const noexcept;
+
+    // Audio thread. True when the message changed the MIDI orientation.
+    bool handleMidiMessage (const juce::MidiMessage& message) noexcept;
+    Orientation getMidiOrientation() const noexcept { return midiOrientation; }
+
+    // Parses one OSC packet (message or bundle); true if it carried an orientation
+    static bool parseOscPacket (const void* data, int size, Orientation& orientation) noexcept;
+
+private:
+    juce::SharedResourcePointer<OscOrientationReceiver> receiver;
+    std::atomic<bool> listening { false };
+
+    // MIDI CC state (audio thread only)
+    static constexpr int firstMsbController = 16;
+    static constexpr int firstLsbController = 48;
+    int msb[3] { 64, 64, 64 };
+    int lsb[3] { 0, 0, 0 };
+    Orientation midiOrientation;
+
+    JUCE_DECLARE_NON_COPYABLE (HeadTrackerInput)
+};
@@ -0,0 +1,67 @@
+#include "ListenerRotation.h"
+
+ListenerRotation ListenerRotation::fromYawPitchRoll (float yawDeg, float pitchDeg, float rollDeg) noexcept
+{
+    ListenerRotation r;
+
+    if (yawDeg == 0.0f && pitchDeg == 0.0f && rollDeg == 0.0f)
+        return r;
+
+    // Axes: x forward, y right, z up. Head -> scene is Rz(yaw) * Ry(pitch) * Rx(roll);
+    // the matrix kept here is its transpose (scene -> head).
+    const float cy = std::cos (juce::degreesToRadians (yawDeg)),   sy = std::sin (juce::degreesToRadians (yawDeg));
+    const float cp = std::cos (juce::degreesToRadians (pitchDeg)), sp = std::sin (juce::degreesToRadians (pitchDeg));
+    const float cr = std::cos (juce::degreesToRadians (rollDeg)),  sr = std::sin (juce::degreesToRadians (rollDeg));
+
+    using Matrix = std::array<std::array<float, 3>, 3>;
+
+    const Matrix yaw   {{ { cy, -sy, 0.0f }, { sy, cy, 0.0f }, { 0.0f, 0.0f, 1.0f } }};
+    const Matrix pitch {{ { cp, 0.0f, -sp }, { 0.0f, 1.0f, 0.0f }, { sp, 0.0f, cp } }}; // forward -> up
+    const Matrix roll  {{ { 1.0f, 0.0f, 0.0f }, { 0.0f, cr, sr }, { 0.0f, -sr, cr } }}; // right -> down
+
+    auto multiply = [] (const Matrix& a, const Matrix& b)
+    {
+        Matrix c {};
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                for (int k = 0; k < 3; ++k)
+                    c[i][j] += a[i][k] * b[k][j];
+        return c;
+    };
+
+    const auto headToScene = multiply (yaw, multiply (pitch, roll));
+
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            r.m[i][j] = headToScene[j][i];
+
+    r.identity = false;
+    return r;
+}
+
+void ListenerRotation::apply (float& azDeg, float& elDeg) const noexcept
+{
+    if (identity)
+        return;
+
+    const float az = juce::degreesToRadians (azDeg);
+    const float el = juce::degreesToRadians (elDeg);
+
+    const float x = std::cos (el) * std::cos (az);
+    const float y = std::cos (el) * std::sin (az);
+    const float z = std::sin (el);
+
+    const float hx = m[0][0] * x + m[0][1] * y + m[0][2] * z;
+    const float hy = m[1][0] * x + m[1][1] * y + m[1][2] * z;
+    const float hz = m[2][0] * x + m[2][1] * y + m[2][2] * z;
+
+    azDeg = juce::radiansToDegrees (std::atan2 (hy, hx));
+    elDeg = juce::radiansToDegrees (std::asin (juce::jlimit (-1.0f, 1.0f, hz)));
+}
+
+float ListenerRotation::foldToFrontDegrees (float azDeg) noexcept
+{
+    if (azDeg > 90.0f)  return 180.0f - azDeg;
+    if (azDeg < -90.0f) return -180.0f - azDeg;
+    return azDeg;
+}
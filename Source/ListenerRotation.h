@@ -0,0 +1,34 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+/**
+    ListenerRotation
+    - The listener's head orientation as a rotation matrix. It turns a source direction in
+      the scene (azimuth/elevation, degrees) into the direction relative to the head.
+    - Azimuth is positive to the right, elevation positive up. Yaw turns the head to the
+      right, pitch tilts the nose up, roll lowers the right ear.
+    - Built off the audio thread or once per control-rate sub-block: a few sin/cos, then
+      every apply() is a 3x3 matrix-vector product plus atan2/asin.
+*/
+class ListenerRotation
+{
+public:
+    ListenerRotation() = default;
+
+    static ListenerRotation fromYawPitchRoll (float yawDeg, float pitchDeg, float rollDeg) noexcept;
+
+    bool isIdentity() const noexcept { return identity; }
+
+    // Scene direction -> head-relative direction. Azimuth comes back in -180..180.
+    void apply (float& azDeg, float& elDeg) const noexcept;
+
+    // Folds directions behind the listener onto their front mirror image (-90..90),
+    // for HRIR sets without rear measurements.
+    static float foldToFrontDegrees (float azDeg) noexcept;
+
+private:
+    float m[3][3] { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } };
+    bool identity = true;
+};
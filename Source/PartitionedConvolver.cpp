@@ -0,0 +1,209 @@
+#include "PartitionedConvolver.h"
+
+namespace
+{
+    // acc += a * b over interleaved complex bins
+    void complexMultiplyAdd (float* acc, const float* a, const float* b, int complexSize) noexcept
+    {
+        for (int i = 0; i < complexSize; i += 2)
+        {
+            acc[i]     += a[i] * b[i]     - a[i + 1] * b[i + 1];
+            acc[i + 1] += a[i] * b[i + 1] + a[i + 1] * b[i];
+        }
+    }
+}
+
+void PartitionedConvolver::prepare (int numSlots, int maxBlockSize, int maxFilterLength)
+{
+    jassert (numSlots > 0 && numSlots <= 32); // slot masks are 32 bits
+
+    partitionSize = juce::jlimit (64, 1024, juce::nextPowerOfTwo (juce::jmax (1, maxBlockSize)));
+    fftSize = partitionSize * 2;
+    complexSize = (partitionSize + 1) * 2;
+    maxPartitions = juce::jmax (1, (maxFilterLength + partitionSize - 1) / partitionSize);
+
+    int order = 0;
+    while ((1 << order) < fftSize)
+        ++order;
+
+    fft = std::make_unique<juce::dsp::FFT> (order);
+    filterFft = std::make_unique<juce::dsp::FFT> (order);
+
+    work.assign ((size_t) fftSize * 2, 0.0f);
+    filterWork.assign ((size_t) fftSize * 2, 0.0f);
+    segment.assign ((size_t) fftSize, 0.0f);
+    history.assign ((size_t) (maxPartitions * complexSize), 0.0f);
+
+    slots.clear();
+    slots.resize ((size_t) numSlots);
+
+    for (auto& slot : slots)
+    {
+        for (int ear = 0; ear < 2; ++ear)
+        {
+            slot.spectra[ear].assign ((size_t) (maxPartitions * complexSize), 0.0f);
+            slot.older[ear].assign ((size_t) complexSize, 0.0f);
+        }
+    }
+
+    reset();
+}
+
+void PartitionedConvolver::reset() noexcept
+{
+    std::fill (segment.begin(), segment.end(), 0.0f);
+    std::fill (history.begin(), history.end(), 0.0f);
+    historyPos = 0;
+    inputPos = 0;
+    ++blockIndex; // older sums were taken from the old history
+}
+
+void PartitionedConvolver::setFilter (int slotIndex, const float* left, const float* right, int length) noexcept
+{
+    auto& slot = slots[(size_t) slotIndex];
+    length = juce::jlimit (0, maxPartitions * partitionSize, length);
+
+    slot.numPartitions = (length + partitionSize - 1) / partitionSize;
+    slot.olderBlock = -1;
+
+    const float* irs[2] = { left, right };
+
+    for (int ear = 0; ear < 2; ++ear)
+    {
+        for (int p = 0; p < slot.numPartitions; ++p)
+        {
+            std::fill (filterWork.begin(), filterWork.end(), 0.0f);
+
+            const int start = p * partitionSize;
+            const int n = juce::jmin (partitionSize, length - start);
+            std::copy (irs[ear] + start, irs[ear] + start + n, filterWork.begin());
+
+            filterFft->performRealOnlyForwardTransform (filterWork.data(), true);
+            std::copy (filterWork.begin(), filterWork.begin() + complexSize,
+                       slot.spectra[ear].begin() + p * complexSize);
+        }
+    }
+}
+
+void PartitionedConvolver::updateOlderPartitions (Slot& slot) noexcept
+{
+    // Partitions 1.. only see complete past blocks: fixed for the whole current block
+    for (int ear = 0; ear < 2; ++ear)
+    {
+        auto& older = slot.older[ear];
+        std::fill (older.begin(), older.end(), 0.0f);
+
+        for (int p = 1; p < slot.numPartitions; ++p)
+        {
+            const int entry = (historyPos - p + maxPartitions) % maxPartitions;
+            complexMultiplyAdd (older.data(), history.data() + entry * complexSize,
+                                slot.spectra[ear].data() + p * complexSize, complexSize);
+        }
+    }
+
+    slot.olderBlock = blockIndex;
+}
+
+const float* PartitionedConvolver::transformChunk (const float* input, int numSamples) noexcept
+{
+    jassert (numSamples <= partitionSize - inputPos);
+
+    chunkPos = inputPos;
+    chunkLength = numSamples;
+
+    // Current block so far (zero padded): one forward FFT shared by every slot
+    std::copy (input, input + numSamples, segment.begin() + partitionSize + inputPos);
+
+    std::copy (segment.begin(), segment.end(), work.begin());
+    std::fill (work.begin() + fftSize, work.end(), 0.0f);
+    fft->performRealOnlyForwardTransform (work.data(), true);
+
+    float* x = history.data() + historyPos * complexSize;
+    std::copy (work.begin(), work.begin() + complexSize, x);
+    return x;
+}
+
+void PartitionedConvolver::addSlotSpectrum (Slot& slot, int ear, const float* x, float* spectrum) noexcept
+{
+    if (slot.olderBlock != blockIndex)
+        updateOlderPartitions (slot);
+
+    juce::FloatVectorOperations::add (spectrum, slot.older[(size_t) ear].data(), complexSize);
+
+    if (slot.numPartitions > 0)
+        complexMultiplyAdd (spectrum, x, slot.spectra[(size_t) ear].data(), complexSize);
+}
+
+void PartitionedConvolver::inverseChunk (float* workBuffer, float* output) noexcept
+{
+    // One inverse FFT; overlap-save keeps the second half
+    std::fill (workBuffer + complexSize, workBuffer + fftSize * 2, 0.0f);
+    fft->performRealOnlyInverseTransform (workBuffer);
+    std::copy (workBuffer + partitionSize + chunkPos, workBuffer + partitionSize + chunkPos + chunkLength, output);
+}
+
+void PartitionedConvolver::finishChunk() noexcept
+{
+    inputPos += chunkLength;
+
+    // Block complete: its spectrum stays in the history, the segment slides on
+    if (inputPos == partitionSize)
+    {
+        std::copy (segment.begin() + partitionSize, segment.end(), segment.begin());
+        std::fill (segment.begin() + partitionSize, segment.end(), 0.0f);
+
+        historyPos = (historyPos + 1) % maxPartitions;
+        inputPos = 0;
+        ++blockIndex;
+    }
+}
+
+void PartitionedConvolver::process (const float* input, int numSamples, unsigned slotMask, float* const* outputs) noexcept
+{
+    int done = 0;
+
+    while (done < numSamples)
+    {
+        const int n = juce::jmin (numSamples - done, partitionSize - inputPos);
+        const float* x = transformChunk (input + done, n);
+
+        for (int s = 0; s < (int) slots.size(); ++s)
+        {
+            if ((slotMask & (1u << s)) == 0)
+                continue;
+
+            for (int ear = 0; ear < 2; ++ear)
+            {
+                std::fill (work.begin(), work.begin() + complexSize, 0.0f);
+                addSlotSpectrum (slots[(size_t) s], ear, x, work.data());
+                inverseChunk (work.data(), outputs[2 * s + ear] + done);
+            }
+        }
+
+        finishChunk();
+        done += n;
+    }
+}
+
+void PartitionedConvolver::addSpectra (const float* input, int numSamples, unsigned slotMask,
+                                       float* spectrumL, float* spectrumR) noexcept
+{
+    const float* x = transformChunk (input, numSamples);
+
+    for (int s = 0; s < (int) slots.size(); ++s)
+    {
+        if ((slotMask & (1u << s)) == 0)
+            continue;
+
+        addSlotSpectrum (slots[(size_t) s], 0, x, spectrumL);
+        addSlotSpectrum (slots[(size_t) s], 1, x, spectrumR);
+    }
+
+    finishChunk();
+}
+
+void PartitionedConvolver::renderSpectrum (float* spectrum, float* output) noexcept
+{
+    std::copy (spectrum, spectrum + complexSize, work.begin());
+    inverseChunk (work.data(), output);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+/**
+    PartitionedConvolver
+    - Zero-latency, uniformly partitioned overlap-save convolution of one mono input with a
+      fixed number of filter slots, each holding a left/right filter pair.
+    - The input spectrum is computed once per call and shared by every slot. A slot costs one
+      complex multiply-add per partition and ear plus one inverse FFT per ear; slots that
+      are not run cost nothing. The input history belongs to the engine, not to the slots,
+      so a slot is exact from the first sample it is run, however long it was skipped.
+    - setFilter() installs a filter synchronously and without allocating, on a non-audio
+      thread, into a slot the audio thread is not running. The caller publishes the slot
+      with a release store and runs it after the matching acquire, so a filter is live
+      exactly when that fence says so: nothing is queued and there is no internal fade.
+    - Several engines can share one output (one engine per input, e.g. the speaker groups of
+      SpeakerBedRenderer): their spectra are summed and transformed back once per ear.
+*/
+class PartitionedConvolver
+{
+public:
+    PartitionedConvolver() = default;
+
+    // Not audio thread. Filters longer than maxFilterLength are truncated.
+    void prepare (int numSlots, int maxBlockSize, int maxFilterLength);
+
+    // Clears the input history (audio thread OK)
+    void reset() noexcept;
+
+    // Not audio thread, and not while process() runs this slot. Shorter filters use fewer
+    // partitions and cost less.
+    void setFilter (int slot, const float* left, const float* right, int length) noexcept;
+
+    // Audio thread. Feeds numSamples of input and writes the output of every slot in
+    // slotMask to outputs[2 * slot] (left) and outputs[2 * slot + 1] (right).
+    void process (const float* input, int numSamples, unsigned slotMask, float* const* outputs) noexcept;
+
+    // Audio thread, several engines into one output. Per chunk, every engine adds the
+    // spectra of its slots in slotMask with addSpectra(), then any one of them turns each
+    // ear's sum into output with renderSpectrum(). Every engine must see the same chunks,
+    // none crossing a block boundary (getSamplesToBlockEnd()). The spectra hold
+    // getSpectrumSize() floats and must be cleared by the caller before each chunk.
+    int getSamplesToBlockEnd() const noexcept { return partitionSize - inputPos; }
+    int getSpectrumSize() const noexcept      { return complexSize; }
+    void addSpectra (const float* input, int numSamples, unsigned slotMask,
+                     float* spectrumL, float* spectrumR) noexcept;
+    // Writes the chunk passed to the last addSpectra() (spectrum is overwritten)
+    void renderSpectrum (float* spectrum, float* output) noexcept;
+
+    int getNumSlots() const noexcept      { return (int) slots.size(); }
+    int getPartitionSize() const noexcept { return partitionSize; }
+
+    // Input that replaces the whole history, wherever the current block stands
+    int getHistoryLength() const noexcept { return (maxPartitions + 1) * partitionSize; }
+
+private:
+    struct Slot
+    {
+        std::vector<float> spectra[2];  // per ear: numPartitions x complexSize, partition 0 first
+        std::vector<float> older[2];    // per ear: partitions 1.. applied to the current history
+        int numPartitions = 0;
+        juce::int64 olderBlock = -1;    // input block the older sums belong to
+    };
+
+    std::vector<Slot> slots;
+
+    int partitionSize = 0;
+    int fftSize = 0;
+    int complexSize = 0;    // interleaved re/im floats of the non-negative bins
+    int maxPartitions = 0;
+    int historyPos = 0;     // ring entry of the current block
+    int inputPos = 0;       // samples of the current block already received
+    int chunkPos = 0, chunkLength = 0; // the last chunk fed, within its block
+    juce::int64 blockIndex = 0;
+
+    std::unique_ptr<juce::dsp::FFT> fft;        // audio thread
+    std::unique_ptr<juce::dsp::FFT> filterFft;  // setFilter()
+    std::vector<float> work, filterWork;        // 2 x fftSize each
+    std::vector<float> segment;                 // [previous block | current block]
+    std::vector<float> history;                 // input spectra, ring of maxPartitions x complexSize
+
+    void updateOlderPartitions (Slot& slot) noexcept;
+
+    // One chunk (within the current block): transforms the block so far into the history
+    const float* transformChunk (const float* input, int numSamples) noexcept;
+    // spectrum += the slot's output spectrum for the chunk (x: its input spectrum)
+    void addSlotSpectrum (Slot& slot, int ear, const float* x, float* spectrum) noexcept;
+    // Inverse FFT of spectrum (fftSize x 2 floats of work), overlap-save part of the chunk
+    void inverseChunk (float* workBuffer, float* output) noexcept;
+    // After the chunk: slides to the next block when this one is complete
+    void finishChunk() noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE (PartitionedConvolver)
+};
@@ -32,7 +32,59 @@ BinauralPannerAudioProcessorEditor::BinauralPannerAudioProcessorEditor (Binaural
                                                             "azimuth",
                                                             azimuthSlider);
 
-    setSize (260, 180);
+    trackerButton.setButtonText ("Head tracker (OSC, UDP " + juce::String (HeadTrackerInput::defaultUdpPort) + ")");
+    trackerButton.setToggleState (audioProcessor.getHeadTracker().isListening(), juce::dontSendNotification);
+    trackerButton.onClick = [this]
+    {
+        // Port taken by another application: fall back to off
+        if (! audioProcessor.setHeadTrackerListening (trackerButton.getToggleState()))
+            trackerButton.setToggleState (false, juce::dontSendNotification);
+    };
+    addAndMakeVisible (trackerButton);
+
+    hrirLengthLabel.setText ("HRIR length", juce::dontSendNotification);
+    hrirLengthLabel.setJustificationType (juce::Justification::centredLeft);
+    addAndMakeVisible (hrirLengthLabel);
+
+    // Item IDs are the taps at 44.1 kHz (full length: 1, since IDs must not be 0)
+    hrirLengthBox.addItem ("Full", 1);
+    for (int taps : { 128, 96, 64, 32 })
+        hrirLengthBox.addItem (juce::String (taps) + " taps", taps);
+
+    const int taps = audioProcessor.getHrirLength();
+    hrirLengthBox.setSelectedId (taps == 0 ? 1 : taps, juce::dontSendNotification);
+    hrirLengthBox.onChange = [this]
+    {
+        const int id = hrirLengthBox.getSelectedId();
+        audioProcessor.setHrirLength (id == 1 ? 0 : id);
+    };
+    addAndMakeVisible (hrirLengthBox);
+
+    lookaheadLabel.setText ("Lookahead", juce::dontSendNotification);
+    lookaheadLabel.setJustificationType (juce::Justification::centredLeft);
+    addAndMakeVisible (lookaheadLabel);
+
+    // Item IDs are the samples (off: 1)
+    lookaheadBox.addItem ("Off", 1);
+    for (int samples : { 256, 1024, 4096 })
+        lookaheadBox.addItem (juce::String (samples) + " samples", samples);
+
+    const int lookahead = audioProcessor.getLookaheadSamples();
+    lookaheadBox.setSelectedId (lookahead == 0 ? 1 : lookahead, juce::dontSendNotification);
+    lookaheadBox.onChange = [this]
+    {
+        const int id = lookaheadBox.getSelectedId();
+        audioProcessor.setLookaheadSamples (id == 1 ? 0 : id);
+    };
+    addAndMakeVisible (lookaheadBox);
+
+    statsLabel.setFont (juce::FontOptions (11.0f));
+    statsLabel.setJustificationType (juce::Justification::topLeft);
+    statsLabel.setColour (juce::Label::textColourId, juce::Colours::lightgrey);
+    addAndMakeVisible (statsLabel);
+    startTimerHz (4);
+
+    setSize (260, 368);
 }
 
 //BinauralPannerAudioProcessorEditor::~BinauralPannerAudioProcessorEditor()
@@ -59,5 +111,34 @@ void BinauralPannerAudioProcessorEditor::resized()
     azimuthLabel.setBounds (area.removeFromTop (24));
     area.removeFromTop (8);
     azimuthSlider.setBounds (area.removeFromTop (120).withSizeKeepingCentre (140, 140));
-    
+    area.removeFromTop (8);
+    trackerButton.setBounds (area.removeFromTop (24));
+    area.removeFromTop (4);
+    auto hrirRow = area.removeFromTop (24);
+    hrirLengthLabel.setBounds (hrirRow.removeFromLeft (90));
+    hrirLengthBox.setBounds (hrirRow);
+    area.removeFromTop (4);
+    auto lookaheadRow = area.removeFromTop (24);
+    lookaheadLabel.setBounds (lookaheadRow.removeFromLeft (90));
+    lookaheadBox.setBounds (lookaheadRow);
+    area.removeFromTop (4);
+    statsLabel.setBounds (area);
+}
+
+void BinauralPannerAudioProcessorEditor::timerCallback()
+{
+    auto* telemetry = audioProcessor.getTelemetry();
+    auto text = telemetry != nullptr ? EngineTelemetry::describe (telemetry->getSnapshot())
+                                     : juce::String ("Binaural engine not loaded");
+    const auto& bank = audioProcessor.getHrirBankReport();
+
+    if (bank.taps > 0)
+        text << "\nHRIR bank: " << bank.taps << " of " << bank.fullTaps << " taps, "
+             << juce::String (bank.memoryBytes / 1024) << " KB\n"
+             << "spectral error " << juce::String (bank.meanSpectralErrorDb, 2) << " dB mean, "
+             << juce::String (bank.maxSpectralErrorDb, 2) << " dB max";
+    else
+        text << "\nHRIR bank: not loaded";
+
+    statsLabel.setText (text, juce::dontSendNotification);
 }
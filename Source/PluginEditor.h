@@ -14,7 +14,8 @@
 //==============================================================================
 /**
 */
-class BinauralPannerAudioProcessorEditor  : public juce::AudioProcessorEditor
+class BinauralPannerAudioProcessorEditor  : public juce::AudioProcessorEditor,
+                                            private juce::Timer
 {
 public:
    explicit BinauralPannerAudioProcessorEditor (BinauralPannerAudioProcessor&);
@@ -35,5 +36,20 @@ private:
     using SliderAttachment = juce::AudioProcessorValueTreeState::SliderAttachment;
     std::unique_ptr<SliderAttachment> azimuthAttachment;
     
+    // Head tracker input (OSC over UDP on localhost)
+    juce::ToggleButton trackerButton;
+    
+    // HRIR length (saved with the state, not automatable); the loaded bank is reported below
+    juce::Label hrirLengthLabel;
+    juce::ComboBox hrirLengthBox;
+    
+    // Lookahead (saved with the state, not automatable; the host re-prepares to apply it)
+    juce::Label lookaheadLabel;
+    juce::ComboBox lookaheadBox;
+    
+    // Engine load and HRIR bank readout (refreshed a few times per second)
+    juce::Label statsLabel;
+    void timerCallback() override;
+    
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BinauralPannerAudioProcessorEditor)
 };
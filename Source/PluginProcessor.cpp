@@ -7,7 +7,19 @@
 */
 
 #include "PluginProcessor.h"
-#include "PluginEditor.h"
+#include "RealtimeGuard.h"
+#include <algorithm>
+#include <limits>
+
+// BINAURALPANNER_HEADLESS builds (offline renderer, benchmarks) link the processor
+// without the editor and without the plugin client's JucePluginDefines.h.
+#if BINAURALPANNER_HEADLESS
+ #ifndef JucePlugin_Name
+  #define JucePlugin_Name "BinauralPanner"
+ #endif
+#else
+ #include "PluginEditor.h"
+#endif
 
 
 //==============================================================================
@@ -23,11 +35,26 @@ BinauralPannerAudioProcessor::BinauralPannerAudioProcessor()
                        apvts(*this, nullptr, "PARAMS", createParameterLayout()) // initialize APVTS
 #endif
 {
+    azimuthParam   = apvts.getRawParameterValue ("azimuth");
+    elevationParam = apvts.getRawParameterValue ("elevation");
+    widthParam     = apvts.getRawParameterValue ("width");
+    distanceParam  = apvts.getRawParameterValue ("distance");
+    modeParam      = apvts.getRawParameterValue ("mode");
+    rendererParam  = apvts.getRawParameterValue ("renderer");
+    yawParam       = apvts.getRawParameterValue ("yaw");
+    pitchParam     = apvts.getRawParameterValue ("pitch");
+    rollParam      = apvts.getRawParameterValue ("roll");
+
+    automatedParameters = { apvts.getParameter ("azimuth"), apvts.getParameter ("elevation"),
+                            apvts.getParameter ("width"), apvts.getParameter ("distance") };
 }
 
-//BinauralPannerAudioProcessor::~BinauralPannerAudioProcessor()
-//{
-//}
+BinauralPannerAudioProcessor::~BinauralPannerAudioProcessor()
+{
+    stopTimer();
+    const juce::ScopedLock sl (engineLock); // a timer callback still running finishes first
+    waitForEngineBuild(); // the build job writes into binauralEngine
+}
 
 //==============================================================================
 const juce::String BinauralPannerAudioProcessor::getName() const
@@ -64,7 +91,15 @@ bool BinauralPannerAudioProcessor::isMidiEffect() const
 
 double BinauralPannerAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    // The Head Model renderer rings for its ITD delay plus its filters' settling. Binaural
+    // convolution rings for one HRIR, and the head model stands in while it loads.
+    // Stereo mode has no tail, but a switch to it keeps the last spatial output ringing.
+    const double headModel = headModelTailSeconds.load();
+    
+    if ((int) rendererParam->load() == 1)
+        return headModel;
+    
+    return juce::jmax (tailLengthSeconds.load(), headModel);
 }
 
 int BinauralPannerAudioProcessor::getNumPrograms()
@@ -95,41 +130,135 @@ void BinauralPannerAudioProcessor::changeProgramName (int index, const juce::Str
 void BinauralPannerAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
     // Prepare Smoothing
-    juce::ignoreUnused(samplesPerBlock);
-    
     const double smoothTimeSec = 0.02; // ramping in 20ms to a new target value (smoothing)
     
     azSmoothDeg.reset (sampleRate, smoothTimeSec);
     elSmoothDeg.reset (sampleRate, smoothTimeSec);
     widthSmooth.reset (sampleRate, smoothTimeSec);
+    distanceSmooth.reset (sampleRate, smoothTimeSec);
+    
+    blockBudgetMicrosPerSample = 1.0e6 / sampleRate;
     
     // set current to current parameter values to avoid a jump on play
-    azSmoothDeg.setCurrentAndTargetValue (apvts.getRawParameterValue("azimuth")->load());
-    elSmoothDeg.setCurrentAndTargetValue (apvts.getRawParameterValue("elevation")->load());
-    widthSmooth.setCurrentAndTargetValue (apvts.getRawParameterValue("width")->load());
+    azSmoothDeg.setCurrentAndTargetValue (azimuthParam->load());
+    elSmoothDeg.setCurrentAndTargetValue (elevationParam->load());
+    widthSmooth.setCurrentAndTargetValue (widthParam->load());
+    distanceSmooth.setCurrentAndTargetValue (distanceParam->load());
+    numParameterChanges = 0;
     
     // ==================== For Bianural Panner Only ========================
-    hrirSrcL.prepare(sampleRate, samplesPerBlock);
-    hrirSrcR.prepare(sampleRate, samplesPerBlock);
+    // The engine is loaded here if it renders from the start (binaural mode with the HRIR
+    // renderer, speaker bed) or is already loaded; otherwise it is built when it is first needed.
+    // stopTimer() does not wait for a callback in progress (a host may prepare from another
+    // thread): the lock does, and keeps the timer out until the engine is handed over.
+    stopTimer();
+    const juce::ScopedLock sl (engineLock);
+    waitForEngineBuild();
+    
+    if (engineState.load() == EngineState::retiring)
+        binauralEngine.reset();
     
-    // After hrirSrcL.prepare / hrirSrcR.prepare:
-    const float initAz = apvts.getRawParameterValue("azimuth")->load();
-    const float initEl = apvts.getRawParameterValue("elevation")->load();
+    const auto inputLayout = getChannelLayoutOfBus (true, 0);
+    const bool isBed = SpeakerBedRenderer::supportsLayout (inputLayout);
+    
+    if (binauralEngine == nullptr && (((int) modeParam->load() == 1 && (int) rendererParam->load() == 0) || isBed))
+        binauralEngine = createBinauralEngine();
+    
+    if (binauralEngine != nullptr)
+    {
+        binauralEngine->cancelWarmUp();
+        prepareBinauralEngine (*binauralEngine, sampleRate);
+        binauralEngine->attachTelemetry (true); // the audio thread is stopped
+        binauralEngine->longerHistory.setSize (0, 0);
+    }
+    
+    // Input kept for warm-ups, enough to refill the whole input history of the convolvers:
+    // the loaded engine's warm-up length, else one full CIPIC HRIR (200 taps at 44.1 kHz)
+    // plus two engine partitions. An engine built later with a longer bank brings its own.
+    const int partitionSize = juce::jlimit (64, 1024, juce::nextPowerOfTwo (controlBlockSize));
+    warmHistory.setSize (2, binauralEngine != nullptr ? binauralEngine->hrirSrcL.getWarmUpLength()
+                                                      : (int) std::ceil (200.0 * sampleRate / 44100.0) + 2 * partitionSize);
+    warmHistory.clear();
+    warmHistoryPos = 0;
+    
+    engine = binauralEngine.get();
+    engineWarm = engine != nullptr; // prepared at the current position, history cleared
+    engineState.store (engine != nullptr ? EngineState::active : EngineState::absent);
+    engineSampleRate = sampleRate;
+    engineReleaseSamples = (juce::int64) (engineReleaseSeconds * sampleRate);
+    engineIdleSamples = 0;
+    
+    controlSamplesRemaining = 0;
+    positionUpdateCountdown = 0;
+    transportWasPlaying = false;
+    transportJumpPending = false;
+    
+    // Lookahead delay, compensated by the host
+    lookaheadSamples = lookaheadSetting.load();
+    setLatencySamples (lookaheadSamples);
+    lookaheadAudio.setSize (juce::jmax (2, getTotalNumInputChannels()), juce::jmax (1, lookaheadSamples));
+    lookaheadAudio.clear();
+    lookaheadWritePos = 0;
+    lookaheadTime = 0;
+    lookaheadFrames.assign (lookaheadSamples > 0 ? (size_t) (lookaheadSamples + samplesPerBlock) : 0, LookaheadFrame{});
+    lookaheadFrameStart = 0;
+    numLookaheadFrames = 0;
+    blockParameters = readBlockParameters();
+    
+    governor.reset();
+    governor.setLevelAvailable (QualityGovernor::Level::truncatedHrirs, engine == nullptr || engine->hrirSrcL.hasReducedHrirBank());
+    applyQualityLevel (QualityGovernor::Level::full);
+    
+    // After the engine is prepared:
+    updateListenerRotation (true);
+    trackerPendingTicks = 0;
+    
+    const float initAz = azimuthParam->load();
+    const float initEl = elevationParam->load();
 
     const float maxSepDeg = 45.0f;
-    const float initWidth = apvts.getRawParameterValue("width")->load();
+    const float initWidth = widthParam->load();
     const float azLf = juce::jlimit (-90.0f, 90.0f, initAz - initWidth * maxSepDeg);
     const float azRf = juce::jlimit (-90.0f, 90.0f, initAz + initWidth * maxSepDeg);
 
-    hrirSrcL.initialiseAtPositionDegrees(azLf, initEl);
-    hrirSrcR.initialiseAtPositionDegrees(azRf, initEl);
+    const float initDistance = distanceSmooth.getCurrentValue();
+    
+    if (engine != nullptr)
+    {
+        engine->hrirSrcL.setDistance (initDistance);
+        engine->hrirSrcR.setDistance (initDistance);
+        engine->hrirSrcL.initialiseAtPositionDegrees(azLf, initEl);
+        engine->hrirSrcR.initialiseAtPositionDegrees(azRf, initEl);
+    }
+    
+    headSrcL.prepare (sampleRate);
+    headSrcR.prepare (sampleRate);
+    headModelTailSeconds.store (headSrcL.getTailLengthSeconds());
+    headSrcL.setDistance (initDistance);
+    headSrcR.setDistance (initDistance);
+    headSrcL.initialiseAtPositionDegrees (azLf, initEl);
+    headSrcR.initialiseAtPositionDegrees (azRf, initEl);
+    headModelMix = 0.0f;
+    headModelRunning = false;
+    headModelMixStep = (float) (1.0 / (0.03 * sampleRate)); // 30 ms engine crossfade
+    
+    modeMix = (int) modeParam->load() != 0 ? 1.0f : 0.0f;
+    modeMixStep = (float) (1.0 / (modeFadeSeconds * sampleRate));
 
-    // set temporary input and output buffers
-    tmpSrcLMono.setSize(1, samplesPerBlock);
-    tmpSrcRMono.setSize(1, samplesPerBlock);
-    tmpSrcLOut.setSize (2, samplesPerBlock);
-    tmpSrcROut.setSize (2, samplesPerBlock);
+    // set temporary input buffers (one control-rate sub-block each).
+    // Nothing below is resized in processBlock: host blocks of any size are consumed in
+    // control-rate pieces, so an oversized block never reallocates on the audio thread.
+    tmpSrcLMono.setSize(1, controlBlockSize);
+    tmpSrcRMono.setSize(1, controlBlockSize);
+    tmpHeadModelOut.setSize(2, controlBlockSize);
+    
+    // Channel bed input: fixed virtual speakers from the same HRIR bank
+    if (isBed)
+        bedRenderer.prepare (inputLayout, engine->hrirSrcL, sampleRate, samplesPerBlock);
+    else
+        bedRenderer = SpeakerBedRenderer();
     
+    startTimer (engineTimerIntervalMs);
 }
 
 void BinauralPannerAudioProcessor::releaseResources()
@@ -153,9 +282,12 @@ bool BinauralPannerAudioProcessor::isBusesLayoutSupported (const BusesLayout& la
      && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
         return false;
 
-    // This checks if the input layout matches the output layout
+    // This checks if the input layout matches the output layout.
+    // A channel bed (5.1, 7.1, 7.1.4) on the input renders down to a stereo output.
    #if ! JucePlugin_IsSynth
-    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
+    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet()
+     && ! (layouts.getMainOutputChannelSet() == juce::AudioChannelSet::stereo()
+           && SpeakerBedRenderer::supportsLayout (layouts.getMainInputChannelSet())))
         return false;
    #endif
 
@@ -171,9 +303,101 @@ static inline void equalPowerGainsFromPan (float panMinus1To1, float& weightL, f
     weightR = std::sin (angle); // project the angle to the right
 }
 
+// Same law through JUCE's rational approximations (gain error up to ~2.3e-7 over the pan
+// range, against ~1.1e-7 for std::cos/std::sin in float: BinauralBench "pan_gains"), for
+// the per-sample ramp where std::cos/std::sin would dominate the cost
+static inline void equalPowerGainsFromPanFast (float panMinus1To1, float& weightL, float& weightR)
+{
+    const float angle = (panMinus1To1 + 1.0f) * 0.25f * juce::MathConstants<float>::pi;
+    weightL = juce::dsp::FastMathApproximations::cos (angle);
+    weightR = juce::dsp::FastMathApproximations::sin (angle);
+}
+
+namespace
+{
+    // 2x2 stereo panning matrix: source L -> (LL, LR), source R -> (RL, RR)
+    struct StereoGains
+    {
+        float LL, LR, RL, RR;
+    };
+}
+
+static inline StereoGains stereoPanGains (float centerAz, float width, float maxSepDeg, bool fast)
+{
+    // find the azimuths for the extended virtual stereo positions, then convert
+    // azimuth(-90, 90) to pan values (-1, 1)
+    const float panL = juce::jlimit (-1.0f, 1.0f, (centerAz - width * maxSepDeg) / 90.0f);
+    const float panR = juce::jlimit (-1.0f, 1.0f, (centerAz + width * maxSepDeg) / 90.0f);
+    
+    StereoGains g;
+    
+    if (fast)
+    {
+        equalPowerGainsFromPanFast (panL, g.LL, g.LR);
+        equalPowerGainsFromPanFast (panR, g.RL, g.RR);
+    }
+    else
+    {
+        equalPowerGainsFromPan (panL, g.LL, g.LR); // stereo panning weights for the left source
+        equalPowerGainsFromPan (panR, g.RL, g.RR); // stereo panning weights for the right source
+    }
+    
+    return g;
+}
+
+// In-place constant-gain matrix mix. The two channels never alias, and the loop carries
+// no state between iterations, so the compiler vectorises it.
+static void mixStereoMatrix (float* __restrict left, float* __restrict right, StereoGains g, int numSamples) noexcept
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float xL = left[i];
+        const float xR = right[i];
+        
+        left[i]  = xL * g.LL + xR * g.RL;
+        right[i] = xL * g.LR + xR * g.RR;
+    }
+}
+
 void BinauralPannerAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
+    RealtimeGuard::ScopedAudioThread realtimeScope; // allocations / locks abort in RT-check builds
+    
+    // Block time vs. the block's real-time budget, reported on every exit path
+    struct BlockTimer
+    {
+        BinauralPannerAudioProcessor& owner;
+        double deadlineSeconds;
+        juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+        
+        ~BlockTimer()
+        {
+            const auto elapsed = juce::Time::getHighResolutionTicks() - startTicks;
+            owner.blockFinished (juce::Time::highResolutionTicksToSeconds (elapsed), deadlineSeconds);
+        }
+    } blockTimer { *this, blockBudgetMicrosPerSample * 1.0e-6 * buffer.getNumSamples() };
+    
+    // The queued automation belongs to this block, whichever way it returns
+    struct ParameterChangeScope
+    {
+        BinauralPannerAudioProcessor& owner;
+        
+        ~ParameterChangeScope() { owner.numParameterChanges = 0; }
+    } parameterChangeScope { *this };
+    
+    nextParameterChange = 0;
+    
+    for (int i = 0; i < numParameterChanges; ++i)
+        parameterChanges[(size_t) i].sampleOffset = juce::jmin (parameterChanges[(size_t) i].sampleOffset,
+                                                                juce::jmax (0, buffer.getNumSamples() - 1));
+    
+    // Quality level chosen at the end of the previous block
+    governor.setEnabled (governorEnabled.load() && ! isNonRealtime());
+    
+    if (governor.getLevel() != appliedQualityLevel)
+        applyQualityLevel (governor.getLevel());
+    
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
@@ -190,133 +414,990 @@ void BinauralPannerAudioProcessor::processBlock (juce::AudioBuffer<float>& buffe
     const int numCh = buffer.getNumChannels();
     const int numSamples = buffer.getNumSamples();
     if (numCh < 2) return;
+    
+    const bool transportJumped = detectTransportJump (numSamples);
+    int jumpOffset = transportJumped ? 0 : -1; // where the smoothers and engines jump
+    
+    // Lookahead: render the input of N samples ago with the parameters of that time
+    if (lookaheadSamples > 0)
+    {
+        delayForLookahead (buffer, numSamples);
+        jumpOffset = scheduleLookahead (numSamples, transportJumped);
+    }
+    else
+    {
+        blockParameters = readBlockParameters();
+    }
+    
+    const int mode = blockParameters.mode;  // 0=Stereo, 1=Binaural
+    const bool headModelRenderer = blockParameters.renderer == 1; // else HRIR convolution
+    
+    // Convolvers: loaded on demand, warmed up before they are heard, released when idle
+    const bool convolutionNeeded = totalNumInputChannels <= 2 && mode == 1 && ! headModelRenderer
+                                    && appliedQualityLevel != QualityGovernor::Level::parametricHead;
+    updateBinauralEngine (numSamples, convolutionNeeded);
+    
+    if (totalNumInputChannels <= 2)
+        captureWarmHistory (buffer, numSamples);
+    
+    // Channel bed: always rendered binaurally, the panner parameters don't apply
+    if (totalNumInputChannels > 2)
+    {
+        if (bedRenderer.isPrepared() && bedRenderer.getNumInputChannels() == totalNumInputChannels)
+            bedRenderer.process (buffer, 0, numSamples);
+        else
+            for (int ch = 0; ch < numCh; ++ch)
+                buffer.clear (ch, 0, numSamples);
+        return;
+    }
     // =================================================================================
     // --- Set targets once per block ---
     
-    // read the prams
-    const float azTargetDeg = apvts.getRawParameterValue("azimuth")->load();
-    const float elTargetDeg = apvts.getRawParameterValue("elevation")->load();
-    const float widthTarget =apvts.getRawParameterValue("width")->load();
+    // (with lookahead the targets come from the frames scheduled above)
+    if (lookaheadSamples == 0)
+    {
+        // read the prams
+        const float azTargetDeg = azimuthParam->load();
+        const float elTargetDeg = elevationParam->load();
+        const float widthTarget = widthParam->load();
+        
+        // set the targets
+        azSmoothDeg.setTargetValue(azTargetDeg);
+        elSmoothDeg.setTargetValue(elTargetDeg);
+        widthSmooth.setTargetValue(widthTarget);    // set the targets
+        distanceSmooth.setTargetValue (distanceParam->load());
+    }
+    
+    // After a locate the automation is already at its new value: start there instead of
+    // gliding from where the previous position left off (queued changes at that sample
+    // are applied first)
+    auto jumpSmoothersIfDue = [&] (int position)
+    {
+        if (jumpOffset < 0 || position < jumpOffset)
+            return false;
+        
+        azSmoothDeg.setCurrentAndTargetValue (azSmoothDeg.getTargetValue());
+        elSmoothDeg.setCurrentAndTargetValue (elSmoothDeg.getTargetValue());
+        widthSmooth.setCurrentAndTargetValue (widthSmooth.getTargetValue());
+        distanceSmooth.setCurrentAndTargetValue (distanceSmooth.getTargetValue());
+        transportJumpPending = true;
+        jumpOffset = -1;
+        return true;
+    };
     
-    // set the targets
-    azSmoothDeg.setTargetValue(azTargetDeg);
-    elSmoothDeg.setTargetValue(elTargetDeg);
-    widthSmooth.setTargetValue(widthTarget);    // set the targets
+    // End of the piece that starts at position: the next queued change or jump
+    auto nextSplit = [&] (int position)
+    {
+        const int jump = jumpOffset > position ? jumpOffset : std::numeric_limits<int>::max();
+        return juce::jmin (getNextParameterChangeOffset(), jump);
+    };
     
     const float maxSepDeg = 45.0f;
     
-    const int mode = (int) apvts.getRawParameterValue("mode")->load();  // 0=Stereo, 1=Binaural
+    // Stereo while it is all that is heard, and while a switch to Binaural waits for the
+    // convolvers to warm up (loaded ones; without any, the head model stands in at once)
+    const bool spatialReady = ! convolutionNeeded || engine == nullptr || engineWarm;
     
-    if (mode ==0)
+    if (modeMix == 0.0f && (mode == 0 || ! spatialReady))
     {
-        // ====================== Stereo Panner ("per-sample smoothing") ================================
-        auto* inL = buffer.getReadPointer (0);
-        auto* inR = buffer.getReadPointer (1);
-        auto* outL = buffer.getWritePointer (0);
-        auto* outR = buffer.getWritePointer (1);
+        // ====================== Stereo Panner ================================
+        // Gains are only recomputed (per sample, fast sin/cos) while azimuth or width
+        // is ramping; the rest of the block is a constant 2x2 matrix mix.
+        // Queued automation splits the block into pieces at its change points.
+        float* outL = buffer.getWritePointer (0);
+        float* outR = buffer.getWritePointer (1);
         
-        // --- Write the output samples ---
-        for (int i = 0; i < numSamples; ++i)
+        int i = 0;
+        
+        while (i < numSamples)
         {
-            // update the pram's ramping value at the current sample
-            const float centerAz = azSmoothDeg.getNextValue(); //-90, 90
-            const float width    = widthSmooth.getNextValue(); //0.0, 1.0
+            applyParameterChanges (i);
+            jumpSmoothersIfDue (i);
+            const int end = juce::jmin (numSamples, nextSplit (i));
             
-            // find the azimuths for the extended virtual stereo positions
-            float azL = juce::jlimit (-90.0f, 90.0f, centerAz - width * maxSepDeg);
-            float azR = juce::jlimit (-90.0f, 90.0f, centerAz + width * maxSepDeg);
+            // --- Ramping: per-sample smoothing ---
+            for (; i < end && (azSmoothDeg.isSmoothing() || widthSmooth.isSmoothing()); ++i)
+            {
+                // update the pram's ramping value at the current sample
+                const float centerAz = azSmoothDeg.getNextValue(); //-90, 90
+                const float width    = widthSmooth.getNextValue(); //0.0, 1.0
             
-            // convert azimuth(-90, 90) to pan values (-1, 1)
-            const float panL = juce::jlimit (-1.0f, 1.0f, azL / 90.0f);
-            const float panR = juce::jlimit (-1.0f, 1.0f, azR / 90.0f);
+                const auto g = stereoPanGains (centerAz, width, maxSepDeg, true);
             
-            // compute the panning weights
-            float gLL, gLR, gRL, gRR;
-            equalPowerGainsFromPan(panL, gLL, gLR); // stereo panning weights for the left source
-            equalPowerGainsFromPan(panR, gRL, gRR); // stereo panning weights for the right source
+                const float xL = outL[i];
+                const float xR = outR[i];
             
-            const float xL = inL[i];
-            const float xR = inR[i];
+                outL[i] = xL * g.LL + xR * g.RL;  // yL = xLL + xRL
+                outR[i] = xL * g.LR + xR * g.RR;  // yR = xLR + xRR
+            }
             
-            outL[i] = xL * gLL + xR * gRL;  // yL = xLL + xRL
-            outR[i] = xL * gLR + xR * gRR;  // yR = xLR + xRR
+            // --- Static: constant gains for the rest of the piece ---
+            if (i < end)
+            {
+                const auto g = stereoPanGains (azSmoothDeg.getCurrentValue(), widthSmooth.getCurrentValue(), maxSepDeg, false);
+                mixStereoMatrix (outL + i, outR + i, g, end - i);
+                i = end;
+            }
         }
+        
+        transportJumpPending = false; // the convolvers catch up when binaural mode resumes
+        headModelRunning = false;     // restarted from a clean state
+        engineWarm = false;           // histories go stale from here: warmed up again
         return;
     }
     
-    // ========================== Binaural Panner ("per-block smoothing")
+    // ========================== Binaural Panner ("per-sub-block smoothing")
+    //
+    // The host block is cut into fixed control-rate sub-blocks. Positions and bilinear
+    // weights are updated once per sub-block, so automation resolution and cost per
+    // sample do not depend on the host buffer size. The sub-block grid carries over
+    // between host blocks (controlSamplesRemaining) and restarts at every queued
+    // automation change, so a change is rendered from its own sample.
+    //
+    // The Head Model renderer (and the governor's parametricHead level) renders with the spherical
+    // head model instead; it ramps its parameters per sample across each sub-block. When
+    // the governor switches engines, both run for a 30 ms crossfade. It also stands in while
+    // the convolvers are being built or warmed up, and crossfades to them once they are ready.
+    //
+    // A switch from or to Stereo fades this path against the stereo mix (equal power).
     
-    // --- advance smoothing across the block and grab the last values ---
-    float centerAz = 0.0f;
-    float centerEl = 0.0f;
-    float width = 0.0f;
+    const bool convolverReady = engine != nullptr && engineWarm;
     
-    for (int i = 0; i < numSamples; ++i)
+    // Nothing convolved can be heard yet: the head model starts at full level. A switch to
+    // the Head Model renderer while the convolvers play ramps over like the governor's switch does.
+    if (! convolverReady)
+        headModelMix = 1.0f;
+    
+    const bool rebuildPending = engine != nullptr && engine->hrirLengthTaps != hrirLengthTaps.load (std::memory_order_relaxed);
+    const float headModelTarget = (headModelRenderer || ! convolverReady || rebuildPending
+                                   || appliedQualityLevel == QualityGovernor::Level::parametricHead) ? 1.0f : 0.0f;
+    const float modeTarget = mode != 0 ? 1.0f : 0.0f;
+    bool ranConvolution = false;
+    
+    // Lookahead: the convolvers load the next cell on the way before the audio gets there
+    if (lookaheadSamples > 0 && headModelTarget < 1.0f)
+        prefetchLookahead (maxSepDeg);
+    
+    int start = 0;
+    auto midiIt = midiMessages.begin();
+    
+    while (start < numSamples)
+    {
+        // Automation due here: the control-rate grid restarts at the change
+        if (applyParameterChanges (start))
+            controlSamplesRemaining = controlBlockSize;
+        
+        const bool jumpsHere = jumpSmoothersIfDue (start);
+        
+        if (controlSamplesRemaining <= 0)
+            controlSamplesRemaining = controlBlockSize;
+        
+        const int n = juce::jmin (controlSamplesRemaining, numSamples - start, nextSplit (start) - start);
+        controlSamplesRemaining -= n;
+        
+        // Head tracking: every tracker update received before this sub-block ends is
+        // rendered in it (MIDI by sample position, UDP by arrival time)
+        for (; midiIt != midiMessages.end() && (*midiIt).samplePosition < start + n; ++midiIt)
+            if (headTracker.handleMidiMessage ((*midiIt).getMessage()))
+                trackerOrientation = headTracker.getMidiOrientation();
+        
+        juce::int64 receivedTicks = 0;
+        if (headTracker.readLatest (trackerSequence, trackerOrientation, receivedTicks))
+            trackerPendingTicks = receivedTicks;
+        
+        if (updateListenerRotation (false))
+            positionUpdateCountdown = 0; // bypass the governor's longer control rate
+        
+        // advance smoothing to the end of this sub-block
+        const float centerAz = azSmoothDeg.skip (n);
+        const float centerEl = elSmoothDeg.skip (n);
+        const float width    = widthSmooth.skip (n);
+        const float distance = distanceSmooth.skip (n);
+        
+        // compute azL/azR for this sub-block
+        const float azLf = juce::jlimit (-90.0f, 90.0f, centerAz - width * maxSepDeg);
+        const float azRf = juce::jlimit (-90.0f, 90.0f, centerAz + width * maxSepDeg);
+        
+        const bool runConvolution = convolverReady && (headModelMix < 1.0f || headModelTarget < 1.0f);
+        ranConvolution = ranConvolution || runConvolution;
+        const bool runHeadModel   = headModelMix > 0.0f || headModelTarget > 0.0f;
+        
+        // Distance is ramped in the output stage from the previous sub-block, so it follows
+        // the smoother every sub-block rather than at the governor's position rate
+        if (runConvolution)
+        {
+            engine->hrirSrcL.setDistance (distance);
+            engine->hrirSrcR.setDistance (distance);
+        }
+        
+        // Transport jump: the new cell is installed in this sub-block, no fade from the old one
+        if (runConvolution && transportJumpPending)
+        {
+            const bool jumpedL = engine->hrirSrcL.jumpToPositionDegrees (azLf, centerEl);
+            const bool jumpedR = engine->hrirSrcR.jumpToPositionDegrees (azRf, centerEl);
+            
+            transportJumpPending = ! (jumpedL && jumpedR);
+            positionUpdateCountdown = positionUpdateInterval;
+        }
+        else if (! runConvolution)
+        {
+            transportJumpPending = false;
+        }
+        else if (--positionUpdateCountdown <= 0)
+        {
+            positionUpdateCountdown = positionUpdateInterval;
+            engine->hrirSrcL.setPositionDegrees (azLf, centerEl);
+            engine->hrirSrcR.setPositionDegrees (azRf, centerEl);
+        }
+        
+        headSrcL.setDistance (distance);
+        headSrcR.setDistance (distance);
+        
+        if (runHeadModel && ! headModelRunning)
+        {
+            headSrcL.reset();
+            headSrcR.reset();
+            headSrcL.initialiseAtPositionDegrees (azLf, centerEl);
+            headSrcR.initialiseAtPositionDegrees (azRf, centerEl);
+        }
+        else if (runHeadModel && jumpsHere)
+        {
+            headSrcL.initialiseAtPositionDegrees (azLf, centerEl);
+            headSrcR.initialiseAtPositionDegrees (azRf, centerEl);
+        }
+        else if (runHeadModel)
+        {
+            headSrcL.setPositionDegrees (azLf, centerEl);
+            headSrcR.setPositionDegrees (azRf, centerEl);
+        }
+        
+        headModelRunning = runHeadModel;
+        
+        // Offline there is no deadline: let the loaders catch up so cell switches
+        // land where the automation says instead of wherever the render got to.
+        if (runConvolution && isNonRealtime())
+        {
+            engine->hrirSrcL.waitForPendingLoad (2000);
+            engine->hrirSrcR.waitForPendingLoad (2000);
+        }
+        
+        // copy in source L and source R (the host buffer is processed in place,
+        // so the inputs must be saved before the convolvers add into it)
+        tmpSrcLMono.copyFrom (0, 0, buffer, 0, start, n); // xL
+        tmpSrcRMono.copyFrom (0, 0, buffer, 1, start, n); // xR
+        
+        float* outL = buffer.getWritePointer (0, start);
+        float* outR = buffer.getWritePointer (1, start);
+        juce::FloatVectorOperations::clear (outL, n);
+        juce::FloatVectorOperations::clear (outR, n);
+        
+        // hrir convolution (with interpolation), accumulated straight into the output:
+        // yL = xLL + xRL, yR = xLR + xRR
+        if (runConvolution)
+        {
+            engine->hrirSrcL.processAndAdd (tmpSrcLMono.getReadPointer (0), outL, outR, n);
+            engine->hrirSrcR.processAndAdd (tmpSrcRMono.getReadPointer (0), outL, outR, n);
+        }
+        
+        if (runHeadModel && ! runConvolution)
+        {
+            headSrcL.processAndAdd (tmpSrcLMono.getReadPointer (0), outL, outR, n);
+            headSrcR.processAndAdd (tmpSrcRMono.getReadPointer (0), outL, outR, n);
+        }
+        else if (runHeadModel)
+        {
+            // Engine crossfade: out = conv + mix * (head - conv), mix ramping per sample
+            float* headL = tmpHeadModelOut.getWritePointer (0);
+            float* headR = tmpHeadModelOut.getWritePointer (1);
+            juce::FloatVectorOperations::clear (headL, n);
+            juce::FloatVectorOperations::clear (headR, n);
+            
+            headSrcL.processAndAdd (tmpSrcLMono.getReadPointer (0), headL, headR, n);
+            headSrcR.processAndAdd (tmpSrcRMono.getReadPointer (0), headL, headR, n);
+            
+            const float step = headModelTarget > headModelMix ? headModelMixStep : -headModelMixStep;
+            
+            for (int i = 0; i < n; ++i)
+            {
+                headModelMix = juce::jlimit (0.0f, 1.0f, headModelMix + step);
+                outL[i] += headModelMix * (headL[i] - outL[i]);
+                outR[i] += headModelMix * (headR[i] - outR[i]);
+            }
+        }
+        
+        // Mode switch: equal-power fade between the stereo mix of this sub-block (at its
+        // end position) and the spatial output
+        if (modeMix < 1.0f || modeTarget < 1.0f)
+        {
+            const auto g = stereoPanGains (centerAz, width, maxSepDeg, false);
+            const float* xL = tmpSrcLMono.getReadPointer (0);
+            const float* xR = tmpSrcRMono.getReadPointer (0);
+            const float step = modeTarget > modeMix ? modeMixStep : -modeMixStep;
+            
+            for (int i = 0; i < n; ++i)
+            {
+                modeMix = juce::jlimit (0.0f, 1.0f, modeMix + step);
+                
+                float stereoGain, spatialGain;
+                equalPowerGainsFromPanFast (2.0f * modeMix - 1.0f, stereoGain, spatialGain);
+                
+                outL[i] = stereoGain * (xL[i] * g.LL + xR[i] * g.RL) + spatialGain * outL[i];
+                outR[i] = stereoGain * (xL[i] * g.LR + xR[i] * g.RR) + spatialGain * outR[i];
+            }
+        }
+        
+        // Tracker latency: packet arrival -> this sub-block rendered, plus its offset in
+        // the host block (it is heard that much after the block starts)
+        if (trackerPendingTicks != 0)
+        {
+            const auto waited = juce::Time::getHighResolutionTicks() - trackerPendingTicks;
+            if (engine != nullptr)
+                engine->telemetry.reportTrackerLatency (juce::Time::highResolutionTicksToSeconds (waited) * 1.0e6
+                                                          + start * blockBudgetMicrosPerSample);
+            trackerPendingTicks = 0;
+        }
+        
+        start += n;
+    }
+    
+    if (! ranConvolution)
+        engineWarm = false; // histories go stale from here: warmed up again
+}
+
+void BinauralPannerAudioProcessor::addParameterChange (AutomatedParameter parameter, int sampleOffset, float value) noexcept
+{
+    if (numParameterChanges >= maxParameterChangesPerBlock)
     {
-        // update the pram's ramping value at the current sample
-        centerAz = azSmoothDeg.getNextValue();
-        centerEl = elSmoothDeg.getNextValue();
-        width = widthSmooth.getNextValue();
+        jassertfalse; // more changes than one block can use: thin them out
+        return;
     }
     
-    // compute final azL/azR for this block
-    const float azLf = juce::jlimit (-90.0f, 90.0f, centerAz - width * maxSepDeg);
-    const float azRf = juce::jlimit (-90.0f, 90.0f, centerAz + width * maxSepDeg);
+    if (const auto* param = automatedParameters[(size_t) parameter])
+        value = juce::jlimit (param->getNormalisableRange().start, param->getNormalisableRange().end, value);
     
-    // Set position with azimuth AND elevation
-    hrirSrcL.setPositionDegrees (azLf, centerEl);
-    hrirSrcR.setPositionDegrees (azRf, centerEl);
+    const ParameterChange change { juce::jmax (0, sampleOffset), parameter, value };
     
-    // prepare mono buffers from input L and input R
-    tmpSrcLMono.setSize (1, numSamples, false, false, true);
-    tmpSrcRMono.setSize (1, numSamples, false, false, true);
+    // Insertion keeps the queue sorted; equal offsets stay in the order they were added
+    int i = numParameterChanges++;
     
-    // copy in source L and source R
-    tmpSrcLMono.copyFrom (0, 0, buffer, 0, 0, numSamples); // xL
-    tmpSrcRMono.copyFrom (0, 0, buffer, 1, 0, numSamples); // xR
+    for (; i > 0 && parameterChanges[(size_t) (i - 1)].sampleOffset > change.sampleOffset; --i)
+        parameterChanges[(size_t) i] = parameterChanges[(size_t) (i - 1)];
     
-    // prepare stereo out buffers 
-    tmpSrcLOut.setSize (2, numSamples, false, false, true);
-    tmpSrcROut.setSize (2, numSamples, false, false, true);
-    tmpSrcLOut.clear();
-    tmpSrcROut.clear();
+    parameterChanges[(size_t) i] = change;
+}
+
+bool BinauralPannerAudioProcessor::applyParameterChanges (int position) noexcept
+{
+    if (nextParameterChange >= numParameterChanges
+        || parameterChanges[(size_t) nextParameterChange].sampleOffset > position)
+        return false;
     
-    // start hrir convolution (with interpolation)
-    hrirSrcL.process (tmpSrcLMono, tmpSrcLOut);
-    hrirSrcR.process (tmpSrcRMono, tmpSrcROut);
+    // Changes closer than the control rate are not worth a sub-block each: they move here
+    const int coalesceEnd = position + controlBlockSize;
     
-    // sum to output
-    buffer.copyFrom (0, 0, tmpSrcLOut, 0, 0, numSamples);
-    buffer.addFrom (0, 0, tmpSrcROut, 0, 0, numSamples);   // yL = xLL + xRL
+    for (; nextParameterChange < numParameterChanges
+           && parameterChanges[(size_t) nextParameterChange].sampleOffset < coalesceEnd; ++nextParameterChange)
+    {
+        const auto& change = parameterChanges[(size_t) nextParameterChange];
+        
+        switch (change.parameter)
+        {
+            case AutomatedParameter::azimuth:   azSmoothDeg.setTargetValue (change.value); break;
+            case AutomatedParameter::elevation: elSmoothDeg.setTargetValue (change.value); break;
+            case AutomatedParameter::width:     widthSmooth.setTargetValue (change.value); break;
+            case AutomatedParameter::distance:  distanceSmooth.setTargetValue (change.value); break;
+        }
+    }
     
-    buffer.copyFrom (1, 0, tmpSrcLOut, 1, 0, numSamples);
-    buffer.addFrom (1, 0, tmpSrcROut, 1, 0, numSamples);    // yR = xLR + xRR
+    return true;
+}
 
+int BinauralPannerAudioProcessor::getNextParameterChangeOffset() const noexcept
+{
+    return nextParameterChange < numParameterChanges ? parameterChanges[(size_t) nextParameterChange].sampleOffset
+                                                      : std::numeric_limits<int>::max();
+}
+
+void BinauralPannerAudioProcessor::delayForLookahead (juce::AudioBuffer<float>& buffer, int numSamples) noexcept
+{
+    // Swapping with the ring outputs the input of N samples ago and keeps the new input
+    const int numChannels = juce::jmin (buffer.getNumChannels(), lookaheadAudio.getNumChannels());
+    int done = 0;
+    
+    while (done < numSamples)
+    {
+        const int n = juce::jmin (numSamples - done, lookaheadSamples - lookaheadWritePos);
+        
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* io = buffer.getWritePointer (ch, done);
+            std::swap_ranges (io, io + n, lookaheadAudio.getWritePointer (ch, lookaheadWritePos));
+        }
+        
+        done += n;
+        lookaheadWritePos = (lookaheadWritePos + n) % lookaheadSamples;
+    }
+}
+
+void BinauralPannerAudioProcessor::pushLookaheadFrame (const LookaheadFrame& frame) noexcept
+{
+    const int capacity = (int) lookaheadFrames.size();
+    
+    if (numLookaheadFrames > 0)
+    {
+        auto& newest = lookaheadFrames[(size_t) ((lookaheadFrameStart + numLookaheadFrames - 1) % capacity)];
+        
+        // A block longer than announced in prepareToPlay: its last frames are merged
+        jassert (newest.time == frame.time || numLookaheadFrames < capacity);
+        
+        // Same sample, or no room left: the newer values replace the newest frame
+        if (newest.time == frame.time || numLookaheadFrames == capacity)
+        {
+            const bool jump = newest.transportJump || frame.transportJump;
+            newest = frame;
+            newest.transportJump = jump;
+            return;
+        }
+    }
+    
+    lookaheadFrames[(size_t) ((lookaheadFrameStart + numLookaheadFrames) % capacity)] = frame;
+    ++numLookaheadFrames;
+}
+
+int BinauralPannerAudioProcessor::scheduleLookahead (int numSamples, bool transportJumped) noexcept
+{
+    // This block's input: its parameter values and queued changes apply N samples later
+    LookaheadFrame frame;
+    frame.time = lookaheadTime + lookaheadSamples;
+    frame.values[0] = azimuthParam->load();
+    frame.values[1] = elevationParam->load();
+    frame.values[2] = widthParam->load();
+    frame.values[3] = distanceParam->load();
+    frame.block = readBlockParameters();
+    frame.transportJump = transportJumped;
+    pushLookaheadFrame (frame);
+    
+    frame.transportJump = false;
+    
+    for (int i = 0; i < numParameterChanges; ++i)
+    {
+        const auto& change = parameterChanges[(size_t) i];
+        frame.time = lookaheadTime + lookaheadSamples + change.sampleOffset;
+        frame.values[(int) change.parameter] = change.value;
+        pushLookaheadFrame (frame);
+    }
+    
+    // The frames due in this output block become its queued changes
+    numParameterChanges = 0;
+    nextParameterChange = 0;
+    int jumpOffset = -1;
+    
+    while (numLookaheadFrames > 0 && lookaheadFrames[(size_t) lookaheadFrameStart].time < lookaheadTime + numSamples)
+    {
+        const auto due = lookaheadFrames[(size_t) lookaheadFrameStart];
+        lookaheadFrameStart = (lookaheadFrameStart + 1) % (int) lookaheadFrames.size();
+        --numLookaheadFrames;
+        
+        const int offset = (int) juce::jmax ((juce::int64) 0, due.time - lookaheadTime);
+        
+        // Queue full: this frame replaces the previous one (they are in time order)
+        if (numParameterChanges + 4 > maxParameterChangesPerBlock)
+            numParameterChanges -= 4;
+        
+        for (int p = 0; p < 4; ++p)
+            addParameterChange ((AutomatedParameter) p, offset, due.values[p]);
+        
+        blockParameters = due.block;
+        
+        if (due.transportJump && jumpOffset < 0)
+            jumpOffset = offset;
+    }
+    
+    lookaheadTime += numSamples;
+    return jumpOffset;
+}
+
+void BinauralPannerAudioProcessor::prefetchLookahead (float maxSepDeg) noexcept
+{
+    // First position on the way that leaves the current cell (per source)
+    auto prefetchNextCell = [this, maxSepDeg] (BinauralConvolver& convolver, float side)
+    {
+        for (int i = 0; i < numLookaheadFrames; ++i)
+        {
+            const auto& f = lookaheadFrames[(size_t) ((lookaheadFrameStart + i) % (int) lookaheadFrames.size())];
+            const float az = juce::jlimit (-90.0f, 90.0f, f.values[0] + side * f.values[2] * maxSepDeg);
+            
+            if (convolver.prefetchPositionDegrees (az, f.values[1]))
+                return;
+        }
+    };
+    
+    prefetchNextCell (engine->hrirSrcL, -1.0f);
+    prefetchNextCell (engine->hrirSrcR,  1.0f);
+}
+
+bool BinauralPannerAudioProcessor::detectTransportJump (int numSamples) noexcept
+{
+    auto* playHead = getPlayHead();
+    if (playHead == nullptr)
+        return false;
+    
+    const auto position = playHead->getPosition();
+    if (! position)
+        return false;
+    
+    const bool playing = position->getIsPlaying();
+    const auto timeInSamples = position->getTimeInSamples();
+    bool jumped = false;
+    
+    if (playing && timeInSamples)
+    {
+        jumped = ! transportWasPlaying || *timeInSamples != transportNextSample;
+        transportNextSample = *timeInSamples + numSamples;
+    }
+    else if (playing)
+    {
+        jumped = ! transportWasPlaying; // no sample position: only play starts are seen
+    }
+    
+    transportWasPlaying = playing;
+    return jumped;
+}
+
+BinauralPannerAudioProcessor::BlockParameters BinauralPannerAudioProcessor::readBlockParameters() const noexcept
+{
+    BlockParameters p;
+    p.mode     = (int) modeParam->load();
+    p.renderer = (int) rendererParam->load();
+    p.yaw      = yawParam->load();
+    p.pitch    = pitchParam->load();
+    p.roll     = rollParam->load();
+    return p;
+}
+
+bool BinauralPannerAudioProcessor::updateListenerRotation (bool force) noexcept
+{
+    // The tracker is live input: only the parameters go through the lookahead
+    const float yaw   = trackerOrientation.yawDeg   + blockParameters.yaw;
+    const float pitch = trackerOrientation.pitchDeg + blockParameters.pitch;
+    const float roll  = trackerOrientation.rollDeg  + blockParameters.roll;
+    
+    if (! force && yaw == listenerYaw && pitch == listenerPitch && roll == listenerRoll)
+        return false;
+    
+    listenerYaw = yaw;
+    listenerPitch = pitch;
+    listenerRoll = roll;
+    
+    const auto rotation = ListenerRotation::fromYawPitchRoll (yaw, pitch, roll);
+    
+    // (a warming engine is not ours until it is done: it gets the rotation then)
+    if (engine != nullptr && engineWarm)
+    {
+        engine->hrirSrcL.setListenerRotation (rotation);
+        engine->hrirSrcR.setListenerRotation (rotation);
+    }
+    
+    headSrcL.setListenerRotation (rotation);
+    headSrcR.setListenerRotation (rotation);
+    return true;
+}
+
+bool BinauralPannerAudioProcessor::setHeadTrackerListening (bool shouldListen, int udpPort)
+{
+    if (! shouldListen)
+    {
+        headTracker.stopListening();
+        return true;
+    }
+    
+    return headTracker.startListening (udpPort);
+}
+
+//==============================================================================
+std::unique_ptr<BinauralPannerAudioProcessor::BinauralEngine> BinauralPannerAudioProcessor::createBinauralEngine()
+{
+    // Detached until the audio thread takes it over
+    return std::make_unique<BinauralEngine>();
+}
+
+void BinauralPannerAudioProcessor::prepareBinauralEngine (BinauralEngine& e, double sampleRate)
+{
+    // The convolvers only ever see control-rate sub-blocks, so they are prepared
+    // for that size rather than the host block size.
+    e.hrirLengthTaps = hrirLengthTaps.load();
+    e.hrirSrcL.setHrirLength (e.hrirLengthTaps);
+    e.hrirSrcR.setHrirLength (e.hrirLengthTaps);
+    e.hrirSrcL.prepare (sampleRate, controlBlockSize);
+    e.hrirSrcR.prepare (sampleRate, controlBlockSize);
+    
+    e.warmInput.setSize (2, e.hrirSrcL.getWarmUpLength());
+    e.warmOutput.setSize (2, e.hrirSrcL.getWarmUpLength());
+    
+    tailLengthSeconds.store (e.hrirSrcL.getTailLengthSeconds());
+}
+
+void BinauralPannerAudioProcessor::waitForEngineBuild() const
+{
+    while (engineState.load() == EngineState::building)
+        juce::Thread::sleep (1);
+}
+
+const BinauralConvolver::HrirBankReport& BinauralPannerAudioProcessor::getHrirBankReport() const noexcept
+{
+    static const BinauralConvolver::HrirBankReport none;
+    const auto state = engineState.load();
+    
+    if (binauralEngine == nullptr || state == EngineState::building)
+        return none;
+    
+    return binauralEngine->hrirSrcL.getHrirBankReport();
+}
+
+void BinauralPannerAudioProcessor::updateBinauralEngine (int numSamples, bool needed) noexcept
+{
+    auto state = engineState.load (std::memory_order_acquire);
+    
+    if (engine == nullptr && state == EngineState::ready)
+    {
+        // Built in the background: take it over (warmed up below before it is heard)
+        engine = binauralEngine.get();
+        engineState.store (EngineState::active, std::memory_order_release);
+        engineIdleSamples = 0;
+        engineWarm = false;
+        
+        // The build job is done with the convolvers
+        engine->attachTelemetry (true);
+        
+        if (engine->longerHistory.getNumSamples() > warmHistory.getNumSamples())
+            adoptLongerWarmHistory();
+        engine->telemetry.reportQualityLevel ((int) appliedQualityLevel);
+        
+        governor.setLevelAvailable (QualityGovernor::Level::truncatedHrirs, engine->hrirSrcL.hasReducedHrirBank());
+    }
+    
+    if (engine == nullptr)
+    {
+        if (needed && state == EngineState::absent)
+            engineState.compare_exchange_strong (state, EngineState::requested);
+        
+        return;
+    }
+    
+    // Built with another HRIR length: not warmed up again, and released once it is no
+    // longer heard (the binaural path fades to the head model first), then rebuilt
+    const bool stale = engine->hrirLengthTaps != hrirLengthTaps.load (std::memory_order_relaxed);
+    const auto warmState = engine->warmState.load (std::memory_order_acquire);
+    
+    if (warmState == BinauralEngine::WarmState::done)
+        finishWarmUp();
+    else if (needed && ! stale && ! engineWarm && warmState == BinauralEngine::WarmState::idle)
+        requestWarmUp();
+    
+    engineIdleSamples = needed ? 0 : engineIdleSamples + numSamples;
+    
+    const bool idle = engineReleaseSamples > 0 && engineIdleSamples >= engineReleaseSamples;
+    const bool replace = stale && (! engineWarm || headModelMix >= 1.0f);
+    
+    if ((idle || replace) && engine->warmState.load() == BinauralEngine::WarmState::idle)
+    {
+        engine = nullptr; // freed by the timer
+        engineWarm = false;
+        engineState.store (EngineState::retiring, std::memory_order_release);
+    }
+}
+
+void BinauralPannerAudioProcessor::captureWarmHistory (const juce::AudioBuffer<float>& buffer, int numSamples) noexcept
+{
+    // The input of this block, before it is processed in place (only the newest part fits)
+    const int length = warmHistory.getNumSamples();
+    const int n = juce::jmin (numSamples, length);
+    const int offset = numSamples - n;
+    const int first = juce::jmin (n, length - warmHistoryPos);
+    
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        warmHistory.copyFrom (ch, warmHistoryPos, buffer, ch, offset, first);
+        warmHistory.copyFrom (ch, 0, buffer, ch, offset + first, n - first);
+    }
+    
+    warmHistoryPos = (warmHistoryPos + n) % length;
+    samplesSinceWarmRequest += numSamples;
+}
+
+void BinauralPannerAudioProcessor::adoptLongerWarmHistory() noexcept
+{
+    // The history so far goes to the end of the longer ring, oldest first; the buffers swap
+    // (no allocation) and the engine frees the shorter one
+    auto& longer = engine->longerHistory;
+    const int length = warmHistory.getNumSamples();
+    const int offset = longer.getNumSamples() - length;
+    const int first = length - warmHistoryPos;
+    
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        longer.copyFrom (ch, offset, warmHistory, ch, warmHistoryPos, first);
+        longer.copyFrom (ch, offset + first, warmHistory, ch, 0, warmHistoryPos);
+    }
+    
+    std::swap (warmHistory, longer);
+    warmHistoryPos = 0;
+}
+
+void BinauralPannerAudioProcessor::requestWarmUp() noexcept
+{
+    // The newest part of the history before this block, oldest first, and where the source is now
+    const int length = warmHistory.getNumSamples();
+    const int n = engine->warmInput.getNumSamples();
+    jassert (n <= length); // warmHistory covers the warm-up (prepareToPlay, adoptLongerWarmHistory)
+    
+    const int begin = (warmHistoryPos - n + length) % length;
+    const int first = juce::jmin (n, length - begin);
+    
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        engine->warmInput.copyFrom (ch, 0, warmHistory, ch, begin, first);
+        engine->warmInput.copyFrom (ch, first, warmHistory, ch, 0, n - first);
+    }
+    
+    const float maxSepDeg = 45.0f;
+    const float centerAz = azSmoothDeg.getCurrentValue();
+    const float width = widthSmooth.getCurrentValue();
+    engine->warmAzL = juce::jlimit (-90.0f, 90.0f, centerAz - width * maxSepDeg);
+    engine->warmAzR = juce::jlimit (-90.0f, 90.0f, centerAz + width * maxSepDeg);
+    engine->warmEl = elSmoothDeg.getCurrentValue();
+    engine->warmDistance = distanceSmooth.getCurrentValue();
+    
+    pushEngineSettings();
+    samplesSinceWarmRequest = 0;
+    engine->attachTelemetry (false); // the warm-up runs on a worker
+    engine->warmState.store (BinauralEngine::WarmState::requested, std::memory_order_release);
+    engine->workerPool->notify();
+}
+
+void BinauralPannerAudioProcessor::finishWarmUp() noexcept
+{
+    engine->attachTelemetry (true);
+    
+    // The blocks rendered while the warm-up ran are still missing from the histories
+    const int length = warmHistory.getNumSamples();
+    const int n = (int) juce::jmin ((juce::int64) length, samplesSinceWarmRequest);
+    const int begin = (warmHistoryPos - n + length) % length;
+    const int first = juce::jmin (n, length - begin);
+    
+    float* outL = engine->warmOutput.getWritePointer (0);
+    float* outR = engine->warmOutput.getWritePointer (1);
+    
+    auto feed = [&] (int from, int count)
+    {
+        juce::FloatVectorOperations::clear (outL, count);
+        juce::FloatVectorOperations::clear (outR, count);
+        engine->hrirSrcL.processAndAdd (warmHistory.getReadPointer (0, from), outL, outR, count);
+        engine->hrirSrcR.processAndAdd (warmHistory.getReadPointer (1, from), outL, outR, count);
+    };
+    
+    if (first > 0)
+        feed (begin, first);
+    
+    if (n > first)
+        feed (0, n - first);
+    
+    engine->warmState.store (BinauralEngine::WarmState::idle, std::memory_order_release);
+    engineWarm = true;
+    pushEngineSettings(); // changes made while it was warming up
+}
+
+void BinauralPannerAudioProcessor::pushEngineSettings() noexcept
+{
+    using Level = QualityGovernor::Level;
+    
+    const auto rotation = ListenerRotation::fromYawPitchRoll (listenerYaw, listenerPitch, listenerRoll);
+    engine->hrirSrcL.setListenerRotation (rotation);
+    engine->hrirSrcR.setListenerRotation (rotation);
+    
+    const auto interpolation = appliedQualityLevel >= Level::nearestCorner ? BinauralConvolver::Interpolation::nearestCorner
+                                                                           : BinauralConvolver::Interpolation::bilinear;
+    engine->hrirSrcL.setInterpolation (interpolation);
+    engine->hrirSrcR.setInterpolation (interpolation);
+    engine->hrirSrcL.setReducedHrirs (appliedQualityLevel >= Level::truncatedHrirs);
+    engine->hrirSrcR.setReducedHrirs (appliedQualityLevel >= Level::truncatedHrirs);
+}
+
+bool BinauralPannerAudioProcessor::BinauralEngine::hasPendingJob (EngineWorkerPool::Priority& priority) const noexcept
+{
+    priority = EngineWorkerPool::Priority::now; // the switch waits for it
+    return warmState.load (std::memory_order_acquire) == WarmState::requested;
+}
+
+void BinauralPannerAudioProcessor::BinauralEngine::runPendingJob()
+{
+    auto expected = WarmState::requested;
+    if (! warmState.compare_exchange_strong (expected, WarmState::running, std::memory_order_acquire))
+        return;
+    
+    // Current cell installed directly (held off only while a set load runs)...
+    hrirSrcL.setDistance (warmDistance);
+    hrirSrcR.setDistance (warmDistance);
+    
+    while (! hrirSrcL.jumpToPositionDegrees (warmAzL, warmEl))
+        juce::Thread::sleep (1);
+    
+    while (! hrirSrcR.jumpToPositionDegrees (warmAzR, warmEl))
+        juce::Thread::sleep (1);
+    
+    // ...then the input history refilled, as if they had been running all along
+    const int n = juce::jmin (warmInput.getNumSamples(), hrirSrcL.getWarmUpLength());
+    const int offset = warmInput.getNumSamples() - n;
+    
+    warmOutput.clear();
+    hrirSrcL.processAndAdd (warmInput.getReadPointer (0, offset), warmOutput.getWritePointer (0), warmOutput.getWritePointer (1), n);
+    hrirSrcR.processAndAdd (warmInput.getReadPointer (1, offset), warmOutput.getWritePointer (0), warmOutput.getWritePointer (1), n);
+    
+    warmState.store (WarmState::done, std::memory_order_release);
+}
+
+void BinauralPannerAudioProcessor::BinauralEngine::cancelWarmUp()
+{
+    auto expected = WarmState::requested;
+    
+    if (! warmState.compare_exchange_strong (expected, WarmState::idle))
+    {
+        while (warmState.load() == WarmState::running)
+            juce::Thread::sleep (1);
+        
+        warmState.store (WarmState::idle);
+    }
+}
+
+void BinauralPannerAudioProcessor::timerCallback()
+{
+    {
+        const juce::ScopedLock sl (engineLock);
+        updateEngineOnMessageThread();
+    }
+    
+    // A new lookahead while prepared: the latency change asks the host to re-prepare,
+    // which is when the delay itself changes
+    if (getLookaheadSamples() != getLatencySamples())
+        setLatencySamples (getLookaheadSamples());
+}
+
+void BinauralPannerAudioProcessor::updateEngineOnMessageThread()
+{
+    const auto state = engineState.load (std::memory_order_acquire);
+    
+    if (state == EngineState::requested)
+    {
+        // Built on the worker pool: decoding the bank takes far longer than a block.
+        // The head model renders meanwhile, so it does not go before set loads.
+        engineState.store (EngineState::building);
+        binauralEngine = createBinauralEngine();
+        
+        binauralEngine->workerPool->addJob (EngineWorkerPool::Priority::prefetch,
+                                            [this, e = binauralEngine.get(), sampleRate = engineSampleRate,
+                                             historyLength = warmHistory.getNumSamples()]
+        {
+            prepareBinauralEngine (*e, sampleRate);
+            
+            if (e->hrirSrcL.getWarmUpLength() > historyLength)
+            {
+                e->longerHistory.setSize (2, e->hrirSrcL.getWarmUpLength());
+                e->longerHistory.clear();
+            }
+            
+            // Warm: set A of the current position is live before the audio thread takes it
+            const float maxSepDeg = 45.0f;
+            const float az = azimuthParam->load(), el = elevationParam->load(), width = widthParam->load();
+            e->hrirSrcL.setDistance (distanceParam->load());
+            e->hrirSrcR.setDistance (distanceParam->load());
+            e->hrirSrcL.initialiseAtPositionDegrees (juce::jlimit (-90.0f, 90.0f, az - width * maxSepDeg), el);
+            e->hrirSrcR.initialiseAtPositionDegrees (juce::jlimit (-90.0f, 90.0f, az + width * maxSepDeg), el);
+            
+            engineState.store (EngineState::ready, std::memory_order_release);
+        });
+    }
+    else if (state == EngineState::retiring)
+    {
+        binauralEngine.reset();
+        engineState.store (EngineState::absent, std::memory_order_release);
+    }
+}
+
+void BinauralPannerAudioProcessor::blockFinished (double elapsedSeconds, double deadlineSeconds) noexcept
+{
+    if (engine != nullptr)
+        engine->telemetry.reportBlock (elapsedSeconds * 1.0e6, deadlineSeconds * 1.0e6);
+    
+    governor.blockFinished (elapsedSeconds, deadlineSeconds); // applied at the start of the next block
+}
+
+void BinauralPannerAudioProcessor::applyQualityLevel (QualityGovernor::Level level) noexcept
+{
+    using Level = QualityGovernor::Level;
+    
+    // Levels are cumulative: each one keeps the savings of the levels above it
+    const auto interpolation = level >= Level::nearestCorner ? BinauralConvolver::Interpolation::nearestCorner
+                                                             : BinauralConvolver::Interpolation::bilinear;
+    
+    if (engine != nullptr && engineWarm)
+    {
+        engine->hrirSrcL.setInterpolation (interpolation);
+        engine->hrirSrcR.setInterpolation (interpolation);
+        
+        engine->hrirSrcL.setReducedHrirs (level >= Level::truncatedHrirs);
+        engine->hrirSrcR.setReducedHrirs (level >= Level::truncatedHrirs);
+    }
+    
+    positionUpdateInterval = level >= Level::longerControlRate ? longerControlRateFactor : 1;
+    
+    appliedQualityLevel = level;
+    
+    if (engine != nullptr)
+        engine->telemetry.reportQualityLevel ((int) level);
 }
 
 //==============================================================================
 bool BinauralPannerAudioProcessor::hasEditor() const
 {
+   #if BINAURALPANNER_HEADLESS
+    return false;
+   #else
     return true; // (change this to false if you choose to not supply an editor)
+   #endif
 }
 
 juce::AudioProcessorEditor* BinauralPannerAudioProcessor::createEditor()
 {
+   #if BINAURALPANNER_HEADLESS
+    return nullptr;
+   #else
     return new BinauralPannerAudioProcessorEditor (*this);
+   #endif
 }
 
 //==============================================================================
 void BinauralPannerAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
+    // The parameters, plus the settings that are not automatable (properties of the tree)
+    auto state = apvts.copyState();
+    state.setProperty ("hrirLength", getHrirLength(), nullptr);
+    state.setProperty ("lookahead", getLookaheadSamples(), nullptr);
+    
+    if (auto xml = state.createXml())
+        copyXmlToBinary (*xml, destData);
 }
 
 void BinauralPannerAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
+    auto xml = getXmlFromBinary (data, sizeInBytes);
+    
+    if (xml == nullptr || ! xml->hasTagName (apvts.state.getType()))
+        return;
+    
+    auto state = juce::ValueTree::fromXml (*xml);
+    setHrirLength ((int) state.getProperty ("hrirLength", 0));
+    setLookaheadSamples ((int) state.getProperty ("lookahead", 0));
+    apvts.replaceState (state);
 }
 
 //==============================================================================
@@ -346,6 +1427,13 @@ juce::AudioProcessorValueTreeState::ParameterLayout BinauralPannerAudioProcessor
             juce::StringArray { "Stereo", "Binaural" },
             0));  // default Stereo
 
+        // Binaural renderer: HRIR convolution or the parametric spherical head model
+        params.push_back (std::make_unique<juce::AudioParameterChoice> (
+            "renderer",
+            "Renderer",
+            juce::StringArray { "HRIR", "Head Model" },
+            0));  // default HRIR
+
         // Width: 0.0 to 1.0
         params.push_back (std::make_unique<juce::AudioParameterFloat> (
             "width",
@@ -353,6 +1441,35 @@ juce::AudioProcessorValueTreeState::ParameterLayout BinauralPannerAudioProcessor
             juce::NormalisableRange<float> (0.0f, 1.0f, 0.001f),
             1.0f));  // default full width
 
+        // Listener orientation (head tracking offset): yaw right, pitch up, roll right ear down
+        params.push_back (std::make_unique<juce::AudioParameterFloat> (
+            "yaw",
+            "Yaw",
+            juce::NormalisableRange<float> (-180.0f, 180.0f, 0.01f),
+            0.0f));
+
+        params.push_back (std::make_unique<juce::AudioParameterFloat> (
+            "pitch",
+            "Pitch",
+            juce::NormalisableRange<float> (-90.0f, 90.0f, 0.01f),
+            0.0f));
+
+        params.push_back (std::make_unique<juce::AudioParameterFloat> (
+            "roll",
+            "Roll",
+            juce::NormalisableRange<float> (-180.0f, 180.0f, 0.01f),
+            0.0f));
+
+        // Distance: 0.2 m (near field) to 20 m, 1 m = the HRIRs as measured
+        juce::NormalisableRange<float> distanceRange (DistanceModel::minMetres, DistanceModel::maxMetres, 0.01f);
+        distanceRange.setSkewForCentre (2.0f);
+
+        params.push_back (std::make_unique<juce::AudioParameterFloat> (
+            "distance",
+            "Distance",
+            distanceRange,
+            1.0f));
+
     return { params.begin(), params.end() };
 }
 
@@ -10,16 +10,23 @@
 
 #include <JuceHeader.h>
 #include "BinauralConvolver.h"
+#include "EngineTelemetry.h"
+#include "QualityGovernor.h"
+#include "SphericalHeadModel.h"
+#include "SpeakerBedRenderer.h"
+#include "HeadTrackerInput.h"
+#include "ListenerRotation.h"
 
 //==============================================================================
 /**
 */
-class BinauralPannerAudioProcessor  : public juce::AudioProcessor
+class BinauralPannerAudioProcessor  : public juce::AudioProcessor,
+                                      private juce::Timer
 {
 public:
     //==============================================================================
     BinauralPannerAudioProcessor();
-    ~BinauralPannerAudioProcessor() override = default;
+    ~BinauralPannerAudioProcessor() override;
     
     //==============================================================================
     void prepareToPlay (double sampleRate, int samplesPerBlock) override;
@@ -60,21 +67,293 @@ public:
 
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
+    // Sample-accurate automation of the position parameters. Changes are queued for the next
+    // processBlock() call, on the audio thread before it, in any order; sampleOffset is
+    // relative to that block (offsets past its end land on its last sample). The block is
+    // rendered in pieces split at the changes; changes less than one control period after a
+    // split are coalesced into it, so splitting at most doubles the number of sub-blocks.
+    // The parameter values themselves still set the targets at the start of every block.
+    enum class AutomatedParameter { azimuth, elevation, width, distance };
+    static constexpr int maxParameterChangesPerBlock = 256;
+    void addParameterChange (AutomatedParameter parameter, int sampleOffset, float value) noexcept;
+
+    // Binaural control rate in samples (position/weight update interval).
+    // Call before prepareToPlay; smaller values track automation more closely at a higher cost.
+    void setControlBlockSize (int numSamples) { controlBlockSize = juce::jlimit (8, 1024, numSamples); }
+    int getControlBlockSize() const noexcept  { return controlBlockSize; }
+
+    // Lookahead: the audio is delayed by numSamples, reported to the host (setLatencySamples),
+    // and rendered with the parameter values read that much earlier: the position ones
+    // sample-accurately, mode, renderer and yaw/pitch/roll at block resolution (the head
+    // tracker itself is live input and is not delayed). The convolvers see
+    // where the source is heading and load the next HRIR cell before the audio that needs
+    // it arrives, so cell switches land on time. 0 = off (default). Saved with the plugin
+    // state, not automatable. Any thread: the delay changes at the next prepareToPlay; a
+    // change while playing is reported as the new latency, which makes hosts re-prepare.
+    static constexpr int maxLookaheadSamples = 65536;
+    void setLookaheadSamples (int numSamples) noexcept { lookaheadSetting.store (juce::jlimit (0, maxLookaheadSamples, numSamples)); }
+    int getLookaheadSamples() const noexcept           { return lookaheadSetting.load(); }
+
+    // HRIR length in taps at 44.1 kHz, 0 = full (see BinauralConvolver::setHrirLength).
+    // Saved with the plugin state. Any thread: a loaded engine is rebuilt with the new
+    // length in the background (the head model stands in meanwhile); a speaker bed picks
+    // it up at the next prepareToPlay.
+    void setHrirLength (int tapsAt44k) noexcept { hrirLengthTaps.store (juce::jmax (0, tapsAt44k)); }
+    int getHrirLength() const noexcept          { return hrirLengthTaps.load(); }
+    // Report of the loaded bank (empty while the binaural engine is not loaded). Message thread.
+    const BinauralConvolver::HrirBankReport& getHrirBankReport() const noexcept;
+
+    // The binaural engine (both convolvers: HRIR bank, filters, set loads) only exists while
+    // binaural mode needs it. prepareToPlay loads it when binaural mode or a speaker bed is
+    // rendered from the start; otherwise it is built and warmed on the worker pool when
+    // binaural mode is first selected, with the head model standing in until it is ready.
+    // It is released after this many seconds without a convolution (0 = kept).
+    // Call before prepareToPlay.
+    void setEngineReleaseDelay (double seconds) noexcept { engineReleaseSeconds = juce::jmax (0.0, seconds); }
+    bool isBinauralEngineLoaded() const noexcept          { return engineState.load() == EngineState::active; }
+
+    // Real-time load statistics of the binaural engine, which owns them (nullptr while it is
+    // not loaded). Message thread, e.g. the editor.
+    EngineTelemetry* getTelemetry() noexcept { return binauralEngine != nullptr ? &binauralEngine->telemetry : nullptr; }
+
+    // Adaptive quality: steps the binaural engine down to cheaper modes under CPU pressure.
+    // On by default; always off while rendering offline.
+    void setQualityGovernorEnabled (bool shouldBeEnabled) noexcept { governorEnabled.store (shouldBeEnabled); }
+    QualityGovernor::Level getQualityLevel() const noexcept         { return appliedQualityLevel; }
+
+    // Head tracking: OSC ".../ypr" on 127.0.0.1:port (MIDI CC 16-18 is always read).
+    // The tracker orientation is added to the yaw/pitch/roll parameters. Message thread.
+    bool setHeadTrackerListening (bool shouldListen, int udpPort = HeadTrackerInput::defaultUdpPort);
+    HeadTrackerInput& getHeadTracker() noexcept { return headTracker; }
+
 private:
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BinauralPannerAudioProcessor)
     
+    // tools/checks inspects the engine's convolvers directly
+    friend struct BinauralCheckAccess;
+    
+    double blockBudgetMicrosPerSample = 0.0;
+    
+    QualityGovernor governor;
+    std::atomic<bool> governorEnabled { true };
+    QualityGovernor::Level appliedQualityLevel = QualityGovernor::Level::full;
+    
+    void blockFinished (double elapsedSeconds, double deadlineSeconds) noexcept;
+    void applyQualityLevel (QualityGovernor::Level level) noexcept;
+
+    // Raw parameter values, looked up by ID once at construction
+    std::atomic<float>* azimuthParam   = nullptr;
+    std::atomic<float>* elevationParam = nullptr;
+    std::atomic<float>* widthParam     = nullptr;
+    std::atomic<float>* distanceParam  = nullptr;
+    std::atomic<float>* modeParam      = nullptr;
+    std::atomic<float>* rendererParam  = nullptr;
+    std::atomic<float>* yawParam       = nullptr;
+    std::atomic<float>* pitchParam     = nullptr;
+    std::atomic<float>* rollParam      = nullptr;
+    std::array<juce::RangedAudioParameter*, 4> automatedParameters {}; // by AutomatedParameter
+
+    // Queued sample-accurate changes, sorted by offset. Filled between blocks; processBlock
+    // consumes them (nextParameterChange) and empties the queue.
+    struct ParameterChange
+    {
+        int sampleOffset;
+        AutomatedParameter parameter;
+        float value;
+    };
+
+    std::array<ParameterChange, maxParameterChangesPerBlock> parameterChanges;
+    int numParameterChanges = 0;
+    int nextParameterChange = 0;
+
+    // Applies the changes due at position, with those less than one control period later
+    // (coalesced). Returns true if any were applied.
+    bool applyParameterChanges (int position) noexcept;
+    int getNextParameterChangeOffset() const noexcept;
+
     // Smoothed prams
     juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> azSmoothDeg;
     juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> elSmoothDeg;
     juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> widthSmooth;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> distanceSmooth; // metres
+    
+    // Separate left and right binaural convolvers, created on demand. binauralEngine belongs
+    // to the message thread (and the build job), with prepareToPlay and the timer serialised
+    // by engineLock; the audio thread renders through engine,
+    // which it takes over and gives back itself. engineState hands it between them:
+    //   absent -> requested (audio) -> building (timer: job queued) -> ready (job)
+    //   -> active (audio takes it over) -> retiring (audio, idle) -> absent (timer frees it)
+    //
+    // The convolvers are only heard once warm: installed at the current position with their
+    // input history refilled from warmHistory (the input of the last blocks, kept in every
+    // mode). That runs on the worker pool (warmState) while the previous output continues;
+    // the audio thread then feeds the blocks rendered meanwhile and takes them back.
+    struct BinauralEngine : private EngineWorkerPool::Client
+    {
+        BinauralEngine()  { workerPool->addClient (*this); }
+        ~BinauralEngine() override { workerPool->removeClient (*this); }
+        
+        juce::SharedResourcePointer<EngineWorkerPool> workerPool; // runs the build and warm-ups
+        EngineTelemetry telemetry; // declared before the convolvers, which report into it
+        BinauralConvolver hrirSrcL;
+        BinauralConvolver hrirSrcR;
+        
+        // The telemetry ring has a single producer, the audio thread: the convolvers only
+        // report into it while the audio thread drives them (not during the build or a warm-up)
+        void attachTelemetry (bool shouldAttach) noexcept
+        {
+            hrirSrcL.setTelemetry (shouldAttach ? &telemetry : nullptr);
+            hrirSrcR.setTelemetry (shouldAttach ? &telemetry : nullptr);
+        }
+        
+        enum class WarmState { idle, requested, running, done };
+        std::atomic<WarmState> warmState { WarmState::idle };
+        
+        // Written by the audio thread before requested, read by the warm-up
+        juce::AudioBuffer<float> warmInput;     // stereo input history, oldest first (getWarmUpLength)
+        juce::AudioBuffer<float> warmOutput;    // discarded output
+        
+        // Built in the background with a bank longer than warmHistory covers: a longer ring,
+        // cleared, that the audio thread swaps in when it takes the engine over
+        juce::AudioBuffer<float> longerHistory;
+        float warmAzL = 0.0f, warmAzR = 0.0f, warmEl = 0.0f, warmDistance = 1.0f;
+        
+        int hrirLengthTaps = 0; // the bank was built with (setHrirLength)
+        
+        // Not audio thread: drops a warm-up that has not started, waits for a running one
+        void cancelWarmUp();
+        
+    private:
+        bool hasPendingJob (EngineWorkerPool::Priority& priority) const noexcept override;
+        void runPendingJob() override;
+        
+        JUCE_DECLARE_NON_COPYABLE (BinauralEngine)
+    };
+    
+    enum class EngineState { absent, requested, building, ready, active, retiring };
+    
+    std::unique_ptr<BinauralEngine> binauralEngine;
+    BinauralEngine* engine = nullptr;                  // audio thread
+    std::atomic<EngineState> engineState { EngineState::absent };
+    juce::CriticalSection engineLock; // binauralEngine: timerCallback vs prepareToPlay / destructor
+    
+    static constexpr int engineTimerIntervalMs = 50;
+    std::atomic<int> hrirLengthTaps { 0 };
+    double engineReleaseSeconds = 30.0;
+    double engineSampleRate = 48000.0;
+    juce::int64 engineReleaseSamples = 0, engineIdleSamples = 0;
+    std::atomic<double> tailLengthSeconds { 0.0 };     // of the last bank loaded
+    std::atomic<double> headModelTailSeconds { 0.0 };  // at the prepared sample rate
+    
+    bool engineWarm = false;                           // audio thread: engine may be heard
+    juce::AudioBuffer<float> warmHistory;              // input ring (stereo), >= the warm-up length
+    int warmHistoryPos = 0;
+    juce::int64 samplesSinceWarmRequest = 0;
+    
+    void captureWarmHistory (const juce::AudioBuffer<float>& buffer, int numSamples) noexcept;
+    void adoptLongerWarmHistory() noexcept;
+    void requestWarmUp() noexcept;
+    void finishWarmUp() noexcept;
+    void pushEngineSettings() noexcept;
+    
+    std::unique_ptr<BinauralEngine> createBinauralEngine();
+    void prepareBinauralEngine (BinauralEngine& e, double sampleRate);
+    void waitForEngineBuild() const;
+    // Audio thread, once per block: takes over a built engine, requests one, or releases it
+    void updateBinauralEngine (int numSamples, bool needed) noexcept;
+    void timerCallback() override;
+    void updateEngineOnMessageThread(); // builds (requested) or frees (retiring), under engineLock
+    
+    // Parametric (spherical head) rendering: the "Head Model" renderer and the governor's last level
+    SphericalHeadModel headSrcL;
+    SphericalHeadModel headSrcR;
+    
+    // 5.1 / 7.1 / 7.1.4 input beds: static virtual speakers, prepared when the input is a bed
+    SpeakerBedRenderer bedRenderer;
+    
+    // Stereo <-> Binaural (either renderer) mode switches: equal-power crossfade.
+    // 0 = stereo only, 1 = spatial only. A switch to Binaural keeps the stereo output until
+    // the convolvers are warm, then fades.
+    static constexpr double modeFadeSeconds = 0.02;
+    float modeMix = 0.0f;
+    float modeMixStep = 0.0f;
+    
+    // 0 = convolution only, 1 = head model only; ramps when the governor switches engines
+    float headModelMix = 0.0f;
+    float headModelMixStep = 0.0f;
+    bool headModelRunning = false; // restarted from a clean state whenever it comes back
+    
+    // Binaural control-rate sub-blocks
+    int controlBlockSize = 32;
+    int controlSamplesRemaining = 0;
+    
+    // Positions are pushed to the convolvers every positionUpdateInterval sub-blocks
+    // (more than 1 only at QualityGovernor::Level::longerControlRate)
+    static constexpr int longerControlRateFactor = 4;
+    int positionUpdateInterval = 1;
+    int positionUpdateCountdown = 0;
+    
+    // Listener orientation: tracker (UDP or MIDI, whichever arrived last) + parameters.
+    // Read once per control-rate sub-block and pushed to every engine when it changes.
+    HeadTrackerInput headTracker;
+    HeadTrackerInput::Orientation trackerOrientation;
+    juce::uint32 trackerSequence = 0;
+    juce::int64 trackerPendingTicks = 0;    // receive time of a packet not yet rendered
+    float listenerYaw = 0.0f, listenerPitch = 0.0f, listenerRoll = 0.0f; // applied, degrees
+    
+    bool updateListenerRotation (bool force) noexcept;
+    
+    // Transport discontinuities from getPlayHead(): a locate while playing, or playback
+    // starting. The smoothers snap to the parameters and the convolvers install the new
+    // cell directly (retried per sub-block while a background load holds them off).
+    bool transportWasPlaying = false;
+    juce::int64 transportNextSample = 0;   // expected timeInSamples of the next block
+    bool transportJumpPending = false;
+    
+    bool detectTransportJump (int numSamples) noexcept;
+    
+    // Parameters read once per block rather than sample-accurately
+    struct BlockParameters
+    {
+        int mode = 0, renderer = 0;
+        float yaw = 0.0f, pitch = 0.0f, roll = 0.0f;
+    };
+    
+    BlockParameters blockParameters; // what this output block renders with
+    BlockParameters readBlockParameters() const noexcept;
+    
+    // Lookahead (see setLookaheadSamples): the input goes through a delay ring (swapped in
+    // place), and the parameter values of the delayed span wait as frames stamped with the
+    // output sample they apply at. Due frames are replayed as queued parameter changes, and
+    // the last one due in a block sets its BlockParameters.
+    // Frames are one per sample at most and span N + one block, so prepareToPlay sizes the
+    // ring for lookahead + samplesPerBlock; only a longer block than announced can fill it.
+    
+    struct LookaheadFrame
+    {
+        juce::int64 time = 0;            // output sample (samples since prepareToPlay)
+        float values[4] {};              // by AutomatedParameter
+        BlockParameters block;
+        bool transportJump = false;
+    };
+    
+    std::atomic<int> lookaheadSetting { 0 };
+    int lookaheadSamples = 0;                // in use since prepareToPlay
+    juce::AudioBuffer<float> lookaheadAudio;
+    int lookaheadWritePos = 0;
+    juce::int64 lookaheadTime = 0;
+    std::vector<LookaheadFrame> lookaheadFrames;
+    int lookaheadFrameStart = 0, numLookaheadFrames = 0;
     
-    // Separate left and right binaural convolvers
-    BinauralConvolver hrirSrcL;
-    BinauralConvolver hrirSrcR;
+    void delayForLookahead (juce::AudioBuffer<float>& buffer, int numSamples) noexcept;
+    void pushLookaheadFrame (const LookaheadFrame& frame) noexcept;
+    // Returns the offset of a transport jump due in this block, or -1
+    int scheduleLookahead (int numSamples, bool transportJumped) noexcept;
+    void prefetchLookahead (float maxSepDeg) noexcept;
     
-    // temp buffers for source and output
+    // temp buffers for the source inputs (outputs are accumulated in place)
     juce::AudioBuffer<float> tmpSrcLMono, tmpSrcRMono;
-    juce::AudioBuffer<float> tmpSrcLOut,  tmpSrcROut;
+    juce::AudioBuffer<float> tmpHeadModelOut; // stereo, only used while the engines crossfade
     
 };
@@ -0,0 +1,167 @@
+#include "QualityGovernor.h"
+
+//==============================================================================
+// Smoothed load of every instance in the process; one slot per governor
+class SessionLoad
+{
+public:
+    static constexpr int maxSlots = 256;
+    static constexpr juce::uint32 staleMs = 500; // no block for this long: not running
+
+    // Message thread (governor construction / destruction)
+    int claimSlot() noexcept
+    {
+        for (int i = 0; i < maxSlots; ++i)
+        {
+            bool expected = false;
+            if (slots[(size_t) i].claimed.compare_exchange_strong (expected, true))
+            {
+                publish (i, 0.0);
+                return i;
+            }
+        }
+
+        return -1;
+    }
+
+    void releaseSlot (int i) noexcept
+    {
+        publish (i, 0.0);
+        slots[(size_t) i].claimed.store (false);
+    }
+
+    // Audio threads, lock-free
+    void publish (int i, double load) noexcept
+    {
+        auto& s = slots[(size_t) i];
+        s.load.store ((float) load, std::memory_order_relaxed);
+        s.lastUpdateMs.store (juce::Time::getMillisecondCounter(), std::memory_order_relaxed);
+    }
+
+    double getTotal() const noexcept
+    {
+        const auto now = juce::Time::getMillisecondCounter();
+        double total = 0.0;
+
+        for (auto& s : slots)
+            if (s.claimed.load (std::memory_order_relaxed)
+                 && now - s.lastUpdateMs.load (std::memory_order_relaxed) < staleMs)
+                total += s.load.load (std::memory_order_relaxed);
+
+        return total;
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<bool> claimed { false };
+        std::atomic<float> load { 0.0f };
+        std::atomic<juce::uint32> lastUpdateMs { 0 };
+    };
+
+    std::array<Slot, maxSlots> slots;
+};
+
+//==============================================================================
+QualityGovernor::QualityGovernor()
+{
+    available.fill (true);
+    sessionSlot = session->claimSlot();
+}
+
+QualityGovernor::~QualityGovernor()
+{
+    if (sessionSlot >= 0)
+        session->releaseSlot (sessionSlot);
+}
+
+void QualityGovernor::reset() noexcept
+{
+    level = Level::full;
+    smoothedLoad = sessionLoad = 0.0;
+    overSeconds = underSeconds = 0.0;
+
+    if (sessionSlot >= 0)
+        session->publish (sessionSlot, 0.0);
+}
+
+void QualityGovernor::setLevelAvailable (Level l, bool isAvailable) noexcept
+{
+    if (l == Level::full)
+        return; // always available
+
+    available[(size_t) l] = isAvailable;
+
+    if (! isAvailable && level == l)
+        level = nextAvailable (l, -1);
+}
+
+void QualityGovernor::setLoadBudget (double fractionOfDeadline) noexcept
+{
+    loadBudget = juce::jlimit (0.05, 1.0, fractionOfDeadline);
+}
+
+QualityGovernor::Level QualityGovernor::nextAvailable (Level from, int direction) const noexcept
+{
+    for (int i = (int) from + direction; i >= 0 && i < numLevels; i += direction)
+        if (available[(size_t) i])
+            return (Level) i;
+
+    return from;
+}
+
+QualityGovernor::Level QualityGovernor::blockFinished (double elapsedSeconds, double deadlineSeconds) noexcept
+{
+    if (! enabled || deadlineSeconds <= 0.0)
+    {
+        reset();
+        return level;
+    }
+
+    // One-pole smoothing with a time constant in seconds, independent of the block size.
+    // The instances share one callback period, so their loads add up.
+    const double alpha = 1.0 - std::exp (-deadlineSeconds / smoothingTimeSeconds);
+    smoothedLoad += alpha * (elapsedSeconds / deadlineSeconds - smoothedLoad);
+
+    if (sessionSlot >= 0)
+    {
+        session->publish (sessionSlot, smoothedLoad);
+        sessionLoad = session->getTotal();
+    }
+    else
+    {
+        sessionLoad = smoothedLoad;
+    }
+
+    const double load = sessionLoad / loadBudget;
+    overSeconds  = load > highWater ? overSeconds + deadlineSeconds  : 0.0;
+    underSeconds = load < lowWater  ? underSeconds + deadlineSeconds : 0.0;
+
+    if (overSeconds >= stepDownHoldSeconds)
+    {
+        level = nextAvailable (level, +1);
+        overSeconds = -smoothingTimeSeconds; // give the cheaper levels time to show their effect
+    }
+    else if (underSeconds >= stepUpHoldSeconds && level != Level::full)
+    {
+        level = nextAvailable (level, -1);
+        underSeconds = 0.0;
+    }
+
+    return level;
+}
+
+const char* QualityGovernor::getLevelName (Level l) noexcept
+{
+    switch (l)
+    {
+        case Level::full:              return "full";
+        case Level::nearestCorner:     return "nearest corner";
+        case Level::truncatedHrirs:    return "truncated HRIRs";
+        case Level::longerControlRate: return "longer control rate";
+        case Level::parametricHead:    return "parametric head";
+        case Level::numLevels:         break;
+    }
+
+    return "";
+}
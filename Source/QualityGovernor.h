@@ -0,0 +1,82 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+/**
+    QualityGovernor
+    - Watches how much of the callback deadline the whole session uses and steps the
+      rendering quality down a ladder of cheaper modes when it runs hot:
+        full -> nearestCorner -> truncatedHrirs -> longerControlRate -> parametricHead
+    - Every instance publishes its smoothed share of its callback period to one
+      process-wide table (held through juce::SharedResourcePointer). The governors compare
+      the sum over all instances that processed a block recently with the session budget,
+      so twenty instances at 4% each step down just like one instance at 80%.
+    - Steps back up once there is headroom again. Step-down reacts within a few hundred ms,
+      step-up needs a few seconds of low load (hysteresis), so it does not oscillate.
+    - Levels the engine cannot provide are marked unavailable and skipped.
+    - Audio thread only (blockFinished), apart from the setters which are called before
+      playback or from the message thread and only store plain values.
+*/
+class SessionLoad;
+
+class QualityGovernor
+{
+public:
+    enum class Level
+    {
+        full = 0,
+        nearestCorner,
+        truncatedHrirs,
+        longerControlRate,
+        parametricHead,
+        numLevels
+    };
+
+    static constexpr int numLevels = (int) Level::numLevels;
+
+    QualityGovernor();
+    ~QualityGovernor();
+
+    void reset() noexcept;
+
+    void setEnabled (bool shouldBeEnabled) noexcept        { enabled = shouldBeEnabled; }
+    bool isEnabled() const noexcept                        { return enabled; }
+
+    void setLevelAvailable (Level level, bool isAvailable) noexcept;
+
+    // Share of the callback deadline all instances together may use before stepping down (0..1)
+    void setLoadBudget (double fractionOfDeadline) noexcept;
+
+    // Audio thread: call once per processBlock with its duration and the block's deadline.
+    // Returns the level to use from the next block on.
+    Level blockFinished (double elapsedSeconds, double deadlineSeconds) noexcept;
+
+    Level getLevel() const noexcept    { return level; }
+    double getSmoothedLoad() const noexcept { return smoothedLoad; }      // this instance
+    double getSessionLoad() const noexcept  { return sessionLoad; }       // all instances
+
+    static const char* getLevelName (Level l) noexcept;
+
+private:
+    static constexpr double smoothingTimeSeconds = 0.3;
+    static constexpr double stepDownHoldSeconds  = 0.25;
+    static constexpr double stepUpHoldSeconds    = 3.0;
+    static constexpr double highWater = 0.85;   // relative to the load budget
+    static constexpr double lowWater  = 0.40;
+
+    juce::SharedResourcePointer<SessionLoad> session;
+    int sessionSlot = -1; // -1: table full, this instance only sees its own load
+
+    std::array<bool, numLevels> available;
+    bool enabled = true;
+    double loadBudget = 0.7;
+
+    Level level = Level::full;
+    double smoothedLoad = 0.0;  // fraction of the deadline, this instance
+    double sessionLoad = 0.0;   // fraction of the deadline, all instances
+    double overSeconds = 0.0;
+    double underSeconds = 0.0;
+
+    Level nextAvailable (Level from, int direction) const noexcept;
+};
@@ -0,0 +1,185 @@
+#include "RealtimeGuard.h"
+
+#if BINAURALPANNER_RT_CHECKS
+
+#include <cstdlib>
+#include <new>
+
+#if JUCE_LINUX
+ #include <dlfcn.h>
+ #include <pthread.h>
+ #include <unistd.h>
+
+ extern "C" void* __libc_malloc  (size_t);
+ extern "C" void* __libc_calloc  (size_t, size_t);
+ extern "C" void* __libc_realloc (void*, size_t);
+ extern "C" void  __libc_free    (void*);
+#else
+ #include <cstdio>
+#endif
+
+namespace
+{
+    thread_local int audioDepth = 0;
+    thread_local int allowDepth = 0;
+
+    inline bool checking() noexcept
+    {
+        return audioDepth > 0 && allowDepth == 0;
+    }
+
+    // Must not allocate: write straight to stderr, then die
+    [[noreturn]] void violation (const char* what) noexcept
+    {
+        static const char prefix[] = "\n*** RealtimeGuard: ";
+        static const char suffix[] = " on the audio thread ***\n";
+
+       #if JUCE_LINUX
+        ::write (2, prefix, sizeof (prefix) - 1);
+        ::write (2, what, std::strlen (what));
+        ::write (2, suffix, sizeof (suffix) - 1);
+       #else
+        std::fputs (prefix, stderr);
+        std::fputs (what, stderr);
+        std::fputs (suffix, stderr);
+       #endif
+
+        std::abort();
+    }
+
+    inline void check (const char* what) noexcept
+    {
+        if (checking())
+        {
+            allowDepth++; // the abort path itself must not re-enter
+            violation (what);
+        }
+    }
+
+   #if JUCE_LINUX
+    using MutexLockFn = int (*) (pthread_mutex_t*);
+    MutexLockFn realMutexLock = nullptr;
+
+    void resolveRealFunctions() noexcept
+    {
+        if (realMutexLock == nullptr)
+            realMutexLock = (MutexLockFn) dlsym (RTLD_NEXT, "pthread_mutex_lock");
+    }
+   #endif
+}
+
+namespace RealtimeGuard
+{
+    ScopedAudioThread::ScopedAudioThread() noexcept
+    {
+       #if JUCE_LINUX
+        resolveRealFunctions(); // dlsym may allocate, so do it before checks are on
+       #endif
+        ++audioDepth;
+    }
+
+    ScopedAudioThread::~ScopedAudioThread() noexcept { --audioDepth; }
+
+    ScopedAllow::ScopedAllow() noexcept  { ++allowDepth; }
+    ScopedAllow::~ScopedAllow() noexcept { --allowDepth; }
+
+    bool isCheckedAudioThread() noexcept { return checking(); }
+}
+
+//==============================================================================
+#if JUCE_LINUX
+extern "C"
+{
+    void* malloc (size_t size)
+    {
+        check ("malloc");
+        return __libc_malloc (size);
+    }
+
+    void* calloc (size_t num, size_t size)
+    {
+        check ("calloc");
+        return __libc_calloc (num, size);
+    }
+
+    void* realloc (void* ptr, size_t size)
+    {
+        check ("realloc");
+        return __libc_realloc (ptr, size);
+    }
+
+    void free (void* ptr)
+    {
+        if (ptr != nullptr)
+            check ("free");
+
+        __libc_free (ptr);
+    }
+
+    int pthread_mutex_lock (pthread_mutex_t* mutex)
+    {
+        check ("pthread_mutex_lock");
+
+        if (realMutexLock == nullptr)
+            resolveRealFunctions();
+
+        return realMutexLock (mutex);
+    }
+}
+#endif
+
+//==============================================================================
+// operator new/delete: on Linux these end up in the malloc hooks above, but hooking
+// them directly gives a clearer message and covers the other platforms.
+void* operator new (std::size_t size)
+{
+    check ("operator new");
+
+    if (auto* p = std::malloc (size == 0 ? 1 : size))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[] (std::size_t size)
+{
+    check ("operator new[]");
+
+    if (auto* p = std::malloc (size == 0 ? 1 : size))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void* operator new (std::size_t size, const std::nothrow_t&) noexcept
+{
+    check ("operator new");
+    return std::malloc (size == 0 ? 1 : size);
+}
+
+void* operator new[] (std::size_t size, const std::nothrow_t&) noexcept
+{
+    check ("operator new[]");
+    return std::malloc (size == 0 ? 1 : size);
+}
+
+void operator delete (void* p) noexcept
+{
+    if (p != nullptr)
+        check ("operator delete");
+
+    std::free (p);
+}
+
+void operator delete[] (void* p) noexcept
+{
+    if (p != nullptr)
+        check ("operator delete[]");
+
+    std::free (p);
+}
+
+void operator delete (void* p, std::size_t) noexcept   { operator delete (p); }
+void operator delete[] (void* p, std::size_t) noexcept { operator delete[] (p); }
+
+#endif // BINAURALPANNER_RT_CHECKS
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    RealtimeGuard
+    - Marks the audio callback so real-time safety can be enforced in test builds.
+    - Build with BINAURALPANNER_RT_CHECKS=1 (benchmark / test executables): any heap
+      allocation, free or mutex acquisition on a thread inside ScopedAudioThread prints
+      what happened and aborts.
+    - Release builds (the default) compile this to nothing.
+
+    Linux hooks malloc/calloc/realloc/free and pthread_mutex_lock (interposed by the
+    executable, so it only covers code linked into a test binary, not a dlopen'ed plugin).
+    Other platforms hook operator new/delete only.
+*/
+#ifndef BINAURALPANNER_RT_CHECKS
+ #define BINAURALPANNER_RT_CHECKS 0
+#endif
+
+namespace RealtimeGuard
+{
+   #if BINAURALPANNER_RT_CHECKS
+    struct ScopedAudioThread
+    {
+        ScopedAudioThread() noexcept;
+        ~ScopedAudioThread() noexcept;
+    };
+
+    // Temporarily lifts the checks (for code we deliberately let block, e.g. test setup)
+    struct ScopedAllow
+    {
+        ScopedAllow() noexcept;
+        ~ScopedAllow() noexcept;
+    };
+
+    bool isCheckedAudioThread() noexcept;
+   #else
+    struct ScopedAudioThread { ScopedAudioThread() noexcept {} };
+    struct ScopedAllow       { ScopedAllow() noexcept {} };
+
+    inline bool isCheckedAudioThread() noexcept { return false; }
+   #endif
+}
@@ -0,0 +1,188 @@
+#include "SpeakerBedRenderer.h"
+
+bool SpeakerBedRenderer::supportsLayout (const juce::AudioChannelSet& layout)
+{
+    return layout == juce::AudioChannelSet::create5point1()
+        || layout == juce::AudioChannelSet::create5point1point4()
+        || layout == juce::AudioChannelSet::create7point1()
+        || layout == juce::AudioChannelSet::create7point1point4();
+}
+
+bool SpeakerBedRenderer::speakerPosition (juce::AudioChannelSet::ChannelType type,
+                                          float& azDeg, float& elDeg, bool& isLfe)
+{
+    using CT = juce::AudioChannelSet::ChannelType;
+
+    // ITU-R BS.775 / BS.2051 positions, azimuth positive to the right
+    isLfe = false;
+    elDeg = 0.0f;
+
+    switch (type)
+    {
+        case CT::left:              azDeg =  -30.0f; return true;
+        case CT::right:             azDeg =   30.0f; return true;
+        case CT::centre:            azDeg =    0.0f; return true;
+        case CT::leftSurround:      azDeg = -110.0f; return true;
+        case CT::rightSurround:     azDeg =  110.0f; return true;
+        case CT::leftSurroundSide:  azDeg =  -90.0f; return true;
+        case CT::rightSurroundSide: azDeg =   90.0f; return true;
+        case CT::leftSurroundRear:  azDeg = -135.0f; return true;
+        case CT::rightSurroundRear: azDeg =  135.0f; return true;
+        case CT::topFrontLeft:      azDeg =  -45.0f; elDeg = 45.0f; return true;
+        case CT::topFrontRight:     azDeg =   45.0f; elDeg = 45.0f; return true;
+        case CT::topRearLeft:       azDeg = -135.0f; elDeg = 45.0f; return true;
+        case CT::topRearRight:      azDeg =  135.0f; elDeg = 45.0f; return true;
+        case CT::LFE:
+        case CT::LFE2:              azDeg = 0.0f; isLfe = true; return true;
+        default:                    break;
+    }
+
+    return false;
+}
+
+void SpeakerBedRenderer::prepare (const juce::AudioChannelSet& layout, const BinauralConvolver& bank,
+                                  double sampleRate, int maxBlockSize)
+{
+    juce::ignoreUnused (sampleRate);
+
+    numChannels = 0;
+    groups.clear();
+    lfeChannels.clear();
+
+    if (! supportsLayout (layout))
+        return;
+
+    // Group the speakers by grid point
+    for (int ch = 0; ch < layout.size(); ++ch)
+    {
+        float az = 0.0f, el = 0.0f;
+        bool isLfe = false;
+
+        if (! speakerPosition (layout.getTypeOfChannel (ch), az, el, isLfe))
+            continue;
+
+        if (isLfe)
+        {
+            lfeChannels.add (ch);
+            continue;
+        }
+
+        // Fold rear speakers to the front mirror image, then snap to the 10 degree grid
+        if (az >  90.0f) az =  180.0f - az;
+        if (az < -90.0f) az = -180.0f - az;
+
+        const int gridAz = juce::roundToInt (az / 10.0f) * 10;
+        const int gridEl = juce::roundToInt (el / 10.0f) * 10;
+
+        auto it = std::find_if (groups.begin(), groups.end(),
+                                [&] (const FilterGroup& g) { return g.azDeg == gridAz && g.elDeg == gridEl; });
+
+        if (it == groups.end())
+        {
+            groups.emplace_back();
+            it = std::prev (groups.end());
+            it->azDeg = gridAz;
+            it->elDeg = gridEl;
+        }
+
+        it->channels.add (ch);
+    }
+
+    // One engine per group, all fed the same chunks so their spectra can be summed
+    juce::AudioBuffer<float> irL, irR;
+
+    for (auto& g : groups)
+    {
+        if (! bank.getHrir (g.azDeg, g.elDeg, true, irL) || ! bank.getHrir (g.azDeg, g.elDeg, false, irR))
+        {
+            irL.setSize (1, 1);
+            irL.clear();
+            irR.makeCopyOf (irL);
+        }
+
+        const int length = juce::jmin (irL.getNumSamples(), irR.getNumSamples());
+        g.engine = std::make_unique<PartitionedConvolver>();
+        g.engine->prepare (1, maxBlockSize, length);
+        g.engine->setFilter (0, irL.getReadPointer (0), irR.getReadPointer (0), length);
+    }
+
+    const int spectrumSize = groups.empty() ? 0 : groups.front().engine->getSpectrumSize();
+    spectrumL.assign ((size_t) spectrumSize, 0.0f);
+    spectrumR.assign ((size_t) spectrumSize, 0.0f);
+
+    const int chunkSize = juce::jmax (1, maxBlockSize);
+    groupInput.setSize (juce::jmax (1, (int) groups.size()), chunkSize);
+    lfeInput.assign ((size_t) chunkSize, 0.0f);
+
+    numChannels = layout.size();
+    reset();
+}
+
+void SpeakerBedRenderer::reset() noexcept
+{
+    for (auto& g : groups)
+        g.engine->reset();
+}
+
+void SpeakerBedRenderer::process (juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    if (! isPrepared() || buffer.getNumChannels() < juce::jmax (2, numChannels))
+        return;
+
+    int done = 0;
+
+    while (done < numSamples)
+    {
+        // Chunks never cross an engine block (the groups stay in step) or the scratch size
+        int n = juce::jmin (numSamples - done, (int) lfeInput.size());
+        if (! groups.empty())
+            n = juce::jmin (n, groups.front().engine->getSamplesToBlockEnd());
+
+        const int pos = startSample + done;
+
+        // Gather every input before channels 0/1 are overwritten
+        for (size_t gi = 0; gi < groups.size(); ++gi)
+        {
+            float* dst = groupInput.getWritePointer ((int) gi);
+            const auto& chans = groups[gi].channels;
+
+            juce::FloatVectorOperations::copy (dst, buffer.getReadPointer (chans[0], pos), n);
+            for (int c = 1; c < chans.size(); ++c)
+                juce::FloatVectorOperations::add (dst, buffer.getReadPointer (chans[c], pos), n);
+        }
+
+        std::fill (lfeInput.begin(), lfeInput.begin() + n, 0.0f);
+        for (int ch : lfeChannels)
+            juce::FloatVectorOperations::addWithMultiply (lfeInput.data(), buffer.getReadPointer (ch, pos), lfeGain, n);
+
+        float* outL = buffer.getWritePointer (0, pos);
+        float* outR = buffer.getWritePointer (1, pos);
+
+        if (groups.empty())
+        {
+            juce::FloatVectorOperations::clear (outL, n);
+            juce::FloatVectorOperations::clear (outR, n);
+        }
+        else
+        {
+            // Spectra summed over the groups, then one inverse FFT per ear
+            std::fill (spectrumL.begin(), spectrumL.end(), 0.0f);
+            std::fill (spectrumR.begin(), spectrumR.end(), 0.0f);
+
+            for (size_t gi = 0; gi < groups.size(); ++gi)
+                groups[gi].engine->addSpectra (groupInput.getReadPointer ((int) gi), n, 1u,
+                                               spectrumL.data(), spectrumR.data());
+
+            groups.front().engine->renderSpectrum (spectrumL.data(), outL);
+            groups.front().engine->renderSpectrum (spectrumR.data(), outR);
+        }
+
+        juce::FloatVectorOperations::add (outL, lfeInput.data(), n);
+        juce::FloatVectorOperations::add (outR, lfeInput.data(), n);
+        done += n;
+    }
+
+    // Beds render to stereo: anything above channel 1 is not an output
+    for (int ch = 2; ch < buffer.getNumChannels(); ++ch)
+        buffer.clear (ch, startSample, numSamples);
+}
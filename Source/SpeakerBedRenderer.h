@@ -0,0 +1,60 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "BinauralConvolver.h"
+#include "PartitionedConvolver.h"
+
+/**
+    SpeakerBedRenderer
+    - Renders a channel bed (5.1, 5.1.4, 7.1, 7.1.4) to binaural through fixed virtual
+      speakers. Each speaker uses the HRIR pair of the nearest grid point of the bank.
+    - The bank has no rear directions (azimuth -90..90), so rear speakers are folded to
+      their front mirror image (110 deg -> 70 deg, 135 deg -> 45 deg).
+    - Speakers that land on the same grid point share one filter: their inputs are summed
+      and convolved once. LFE channels bypass the HRIRs.
+    - Positions never move, so there is no loader, no A/B crossfade and the cost per block
+      is fixed. Each filter group is a one-slot PartitionedConvolver (zero latency): one
+      input FFT per group feeds both ears, and the ears' spectra are summed over all
+      groups before one inverse FFT per ear.
+*/
+class SpeakerBedRenderer
+{
+public:
+    SpeakerBedRenderer() = default;
+
+    static bool supportsLayout (const juce::AudioChannelSet& layout);
+
+    // Not audio thread. bank must already be prepared at sampleRate.
+    void prepare (const juce::AudioChannelSet& layout, const BinauralConvolver& bank,
+                  double sampleRate, int maxBlockSize);
+    void reset() noexcept;
+
+    bool isPrepared() const noexcept          { return numChannels > 0; }
+    int getNumInputChannels() const noexcept  { return numChannels; }
+    int getNumFilterGroups() const noexcept   { return (int) groups.size(); }
+
+    // Reads the bed from channels 0..getNumInputChannels()-1 of buffer and writes the
+    // binaural result into channels 0 (left) and 1 (right), in place.
+    void process (juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+
+private:
+    static constexpr float lfeGain = 0.7071f; // -3 dB into each ear
+
+    struct FilterGroup
+    {
+        int azDeg = 0, elDeg = 0;
+        juce::Array<int> channels;
+        std::unique_ptr<PartitionedConvolver> engine; // one slot: the HRIR pair
+    };
+
+    int numChannels = 0;
+    juce::Array<int> lfeChannels;
+    std::vector<FilterGroup> groups;
+
+    std::vector<float> spectrumL, spectrumR;       // output spectra of one chunk
+    juce::AudioBuffer<float> groupInput;           // numGroups x maxBlockSize
+    std::vector<float> lfeInput;
+
+    static bool speakerPosition (juce::AudioChannelSet::ChannelType type, float& azDeg, float& elDeg, bool& isLfe);
+};
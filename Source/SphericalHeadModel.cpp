@@ -0,0 +1,163 @@
+#include "SphericalHeadModel.h"
+
+void SphericalHeadModel::prepare (double sampleRate)
+{
+    fs = sampleRate;
+
+    beta = 2.0f * speedOfSound / headRadiusMetres;
+    k = 2.0f * (float) fs;
+    invNorm = 1.0f / (beta + k);
+    a1 = (beta - k) * invNorm;
+
+    shelfHighPass.coefficients = juce::dsp::IIR::Coefficients<float>::makeHighPass (
+        fs, juce::jmin ((double) shelfFrequency, fs * 0.45));
+    nearFieldShelfCoeff = DistanceModel::shelfCoefficient (fs);
+
+    // Longest ITD path is (a / c) * (1 + pi / 2), plus the Lagrange taps
+    const float maxDelay = headRadiusMetres / speedOfSound * (1.0f + juce::MathConstants<float>::halfPi) * (float) fs;
+    const int size = juce::nextPowerOfTwo ((int) std::ceil (maxDelay) + 8);
+
+    delayLine.assign ((size_t) size, 0.0f);
+    delayMask = size - 1;
+
+    reset();
+}
+
+double SphericalHeadModel::getTailLengthSeconds() const noexcept
+{
+    const double maxDelay = headRadiusMetres / speedOfSound * (1.0 + juce::MathConstants<double>::halfPi) * fs + 2.0;
+
+    // One-pole decays: the head shadow (pole at -a1) and the near-field shelf. The
+    // elevation high-pass and the air absorption are far faster.
+    const double slowestPole = juce::jmax ((double) std::abs (a1), 1.0 - (double) nearFieldShelfCoeff);
+    const double settle = slowestPole > 0.0 ? std::log (1.0e-6) / std::log (slowestPole) : 0.0;
+
+    return std::ceil (maxDelay + settle) / fs;
+}
+
+void SphericalHeadModel::reset() noexcept
+{
+    std::fill (delayLine.begin(), delayLine.end(), 0.0f);
+    writePos = 0;
+    shadowL.state = shadowR.state = 0.0f;
+    shelfHighPass.reset();
+    distanceState = {};
+}
+
+void SphericalHeadModel::initialiseAtPositionDegrees (float azDeg, float elDeg) noexcept
+{
+    listenerRotation.apply (azDeg, elDeg);
+    target = current = computeParams (azDeg, elDeg);
+    distanceTarget = distanceCurrent = computeDistanceParams (azDeg, elDeg);
+}
+
+void SphericalHeadModel::setPositionDegrees (float azDeg, float elDeg) noexcept
+{
+    listenerRotation.apply (azDeg, elDeg);
+    target = computeParams (azDeg, elDeg);
+    distanceTarget = computeDistanceParams (azDeg, elDeg);
+}
+
+SphericalHeadModel::Params SphericalHeadModel::computeParams (float azDeg, float elDeg) const noexcept
+{
+    const float az = juce::degreesToRadians (azDeg);
+    const float el = juce::degreesToRadians (elDeg);
+
+    // Cosine of the angle between the source and the interaural axis (+1 = right ear)
+    const float lateral = juce::jlimit (-1.0f, 1.0f, std::sin (az) * std::cos (el));
+
+    const float thetaMin = juce::degreesToRadians (thetaMinDegrees);
+    const float headDelay = headRadiusMetres / speedOfSound * (float) fs;
+
+    auto ear = [&] (float cosIncidence, float& alpha, float& delay)
+    {
+        const float theta = std::acos (cosIncidence); // 0 = on the ear axis
+
+        alpha = (1.0f + alphaMin * 0.5f)
+              + (1.0f - alphaMin * 0.5f) * std::cos (theta / thetaMin * juce::MathConstants<float>::pi);
+
+        // Brown-Duda delay, shifted to be >= 0, plus one sample for the Lagrange taps
+        const float t = theta < juce::MathConstants<float>::halfPi
+                          ? -std::cos (theta)
+                          : theta - juce::MathConstants<float>::halfPi;
+
+        delay = 1.0f + headDelay * (1.0f + t);
+    };
+
+    Params p;
+    ear ( lateral, p.alphaR, p.delayR);
+    ear (-lateral, p.alphaL, p.delayL);
+
+    p.shelfGain = juce::Decibels::decibelsToGain (shelfMaxDb * std::sin (el)) - 1.0f;
+    return p;
+}
+
+DistanceModel::Params SphericalHeadModel::computeDistanceParams (float azDeg, float elDeg) const noexcept
+{
+    const float lateral = std::sin (juce::degreesToRadians (azDeg)) * std::cos (juce::degreesToRadians (elDeg));
+    return DistanceModel::computeParams (distanceMetres, lateral, fs);
+}
+
+float SphericalHeadModel::readDelay (float delaySamples) const noexcept
+{
+    const int   i = (int) delaySamples;
+    const float f = delaySamples - (float) i;
+
+    // 3rd-order Lagrange over the taps at delays i-1, i, i+1, i+2
+    const float hm1 = -f * (f - 1.0f) * (f - 2.0f) * (1.0f / 6.0f);
+    const float h0  = (f + 1.0f) * (f - 1.0f) * (f - 2.0f) * 0.5f;
+    const float h1  = -(f + 1.0f) * f * (f - 2.0f) * 0.5f;
+    const float h2  = (f + 1.0f) * f * (f - 1.0f) * (1.0f / 6.0f);
+
+    const int base = writePos - i;
+
+    return hm1 * delayLine[(size_t) ((base + 1) & delayMask)]
+         + h0  * delayLine[(size_t) ( base      & delayMask)]
+         + h1  * delayLine[(size_t) ((base - 1) & delayMask)]
+         + h2  * delayLine[(size_t) ((base - 2) & delayMask)];
+}
+
+void SphericalHeadModel::processAndAdd (const float* monoIn, float* outL, float* outR, int numSamples) noexcept
+{
+    if (delayLine.empty() || numSamples <= 0)
+        return;
+
+    const float inv = 1.0f / (float) numSamples;
+    const Params start = current;
+    const Params step { (target.alphaL - start.alphaL) * inv, (target.alphaR - start.alphaR) * inv,
+                        (target.delayL - start.delayL) * inv, (target.delayR - start.delayR) * inv,
+                        (target.shelfGain - start.shelfGain) * inv };
+
+    // Distance stage per ear, skipped at the 1 m identity
+    const bool withDistance = ! (distanceTarget.isIdentity() && distanceCurrent.isIdentity());
+    const auto rampL = DistanceModel::makeRamp (distanceCurrent, distanceTarget, 0, nearFieldShelfCoeff, numSamples);
+    const auto rampR = DistanceModel::makeRamp (distanceCurrent, distanceTarget, 1, nearFieldShelfCoeff, numSamples);
+    DistanceModel::Stage distanceL (rampL, distanceState[0]);
+    DistanceModel::Stage distanceR (rampR, distanceState[1]);
+
+    for (int n = 0; n < numSamples; ++n)
+    {
+        const float t = (float) (n + 1);
+
+        // Elevation shelf: x + g * highpass(x)
+        const float x = monoIn[n];
+        delayLine[(size_t) writePos] = x + (start.shelfGain + t * step.shelfGain) * shelfHighPass.processSample (x);
+
+        const float dL = readDelay (start.delayL + t * step.delayL);
+        const float dR = readDelay (start.delayR + t * step.delayR);
+
+        const float yL = shadowL.process (dL, start.alphaL + t * step.alphaL, beta, k, invNorm, a1);
+        const float yR = shadowR.process (dR, start.alphaR + t * step.alphaR, beta, k, invNorm, a1);
+
+        outL[n] += withDistance ? distanceL.process (yL, t) : yL;
+        outR[n] += withDistance ? distanceR.process (yR, t) : yR;
+
+        writePos = (writePos + 1) & delayMask;
+    }
+
+    if (withDistance)
+        distanceState = { distanceL.getState(), distanceR.getState() };
+
+    current = target;
+    distanceCurrent = distanceTarget;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+#include "DistanceModel.h"
+#include "ListenerRotation.h"
+
+/**
+    SphericalHeadModel
+    - Parametric binaural rendering for one mono source: the head is a rigid sphere.
+    - Per ear: a Brown-Duda first-order head-shadow filter (up to +6 dB towards the ear,
+      about -20 dB of HF in the shadow) after a fractional delay that models the ITD
+      (3rd-order Lagrange interpolation).
+    - Elevation: a fixed high-pass biquad mixed back in with a position-dependent gain,
+      i.e. a high shelf that lifts sources above and darkens sources below.
+    - Distance: the convolver's output stage (DistanceModel) on each ear.
+    - No HRIRs, no loader thread, no FFTs: a few multiply-adds per sample, so it suits
+      previews, large source counts and the QualityGovernor's last step.
+    - Same audio-thread API shape as BinauralConvolver. Positions set per call are reached
+      at the end of the next processAndAdd, every parameter is ramped per sample.
+*/
+class SphericalHeadModel
+{
+public:
+    SphericalHeadModel() = default;
+
+    // Not audio thread (allocates the delay line)
+    void prepare (double sampleRate);
+    void reset() noexcept;
+
+    // Jumps straight to a position (no ramp). Call after prepare().
+    void initialiseAtPositionDegrees (float azDeg, float elDeg) noexcept;
+
+    // Audio thread
+    void setPositionDegrees (float azDeg, float elDeg) noexcept;
+
+    // Listener head orientation, applied to every position set afterwards. The sphere is
+    // front/back symmetric, so rear directions need no special handling.
+    void setListenerRotation (const ListenerRotation& r) noexcept { listenerRotation = r; }
+
+    // Source distance in metres (DistanceModel, 1 m = unity, as the convolver).
+    // Takes effect at the next position update.
+    void setDistance (float metres) noexcept { distanceMetres = juce::jlimit (DistanceModel::minMetres, DistanceModel::maxMetres, metres); }
+
+    // Reads numSamples from monoIn and ADDS the binaural result into outL/outR.
+    void processAndAdd (const float* monoIn, float* outL, float* outR, int numSamples) noexcept;
+
+    // Output after the input stops: the longest ITD delay, then the slowest filter decaying
+    // below -120 dBFS. Valid after prepare().
+    double getTailLengthSeconds() const noexcept;
+
+private:
+    static constexpr float headRadiusMetres = DistanceModel::headRadiusMetres;
+    static constexpr float speedOfSound     = DistanceModel::speedOfSound;
+    static constexpr float alphaMin         = 0.1f;    // shadow depth (Brown-Duda)
+    static constexpr float thetaMinDegrees  = 150.0f;  // angle of deepest shadow
+    static constexpr float shelfFrequency   = 6000.0f;
+    static constexpr float shelfMaxDb       = 4.0f;    // at +/-90 deg elevation
+
+    // Everything that depends on position; ramped linearly between calls
+    struct Params
+    {
+        float alphaL = 1.0f, alphaR = 1.0f;   // head-shadow HF gain
+        float delayL = 1.0f, delayR = 1.0f;   // samples
+        float shelfGain = 0.0f;               // linear gain - 1 applied to the high-passed input
+    };
+
+    Params computeParams (float azDeg, float elDeg) const noexcept;
+    DistanceModel::Params computeDistanceParams (float azDeg, float elDeg) const noexcept;
+
+    struct ShadowFilter
+    {
+        float state = 0.0f;
+
+        // H(s) = (beta + alpha s) / (beta + s), bilinear transformed; only b0/b1 depend on alpha
+        float process (float x, float alpha, float beta, float k, float invNorm, float a1) noexcept
+        {
+            const float b0 = (beta + alpha * k) * invNorm;
+            const float b1 = (beta - alpha * k) * invNorm;
+            const float y = b0 * x + state;
+            state = b1 * x - a1 * y;
+            return y;
+        }
+    };
+
+    float readDelay (float delaySamples) const noexcept;
+
+    double fs = 48000.0;
+    Params current, target;
+    ListenerRotation listenerRotation;
+    float distanceMetres = 1.0f;
+    float nearFieldShelfCoeff = 0.0f;
+    DistanceModel::Params distanceCurrent, distanceTarget;
+    std::array<DistanceModel::State, 2> distanceState {};
+
+    // Shadow filter constants (beta = 2 * c / a, k = 2 fs)
+    float beta = 0.0f, k = 0.0f, invNorm = 0.0f, a1 = 0.0f;
+    ShadowFilter shadowL, shadowR;
+
+    juce::dsp::IIR::Filter<float> shelfHighPass;
+
+    std::vector<float> delayLine;
+    int delayMask = 0;
+    int writePos = 0;
+};
@@ -0,0 +1,946 @@
+/*
+  ==============================================================================
+
+    BinauralBench - micro-benchmarks for BinauralConvolver and the processor.
+
+    Every case reports ns/sample, ns/block and the realtime factor for one
+    (sample rate, block size) pair. Results are written as JSON so runs can be
+    diffed between releases.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/BinauralConvolver.h"
+#include "../../../Source/PluginProcessor.h"
+#include "../../../Source/RealtimeGuard.h"
+#include "../../../Source/SphericalHeadModel.h"
+#include "../../../Source/SpeakerBedRenderer.h"
+
+#include <iostream>
+
+//==============================================================================
+// Reaches the private kernels (declared friend in BinauralConvolver)
+struct BinauralBenchmarkAccess
+{
+    static bool isCrossfading (const BinauralConvolver& c)  { return c.numStates > 1 || c.hasBReady.load(); }
+
+    static void processSetA (BinauralConvolver& c, const float* in, int numSamples)
+    {
+        const auto slots = c.slotMask (c.states[0].corners, BinauralConvolver::allCorners);
+        c.processSlots (in, numSamples, slots, slots);
+    }
+};
+
+namespace
+{
+    //==============================================================================
+    struct Options
+    {
+        double secondsPerCase = 1.0; // audio seconds processed per measurement
+        juce::Array<double> sampleRates { 44100.0, 48000.0, 96000.0, 192000.0 };
+        juce::Array<int> blockSizes { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+        juce::Array<int> controlRates { 16, 32, 64, 128, 256 };
+        juce::String only;
+    };
+
+    struct Result
+    {
+        juce::String name;
+        double sampleRate = 0.0;
+        int blockSize = 0;
+        int controlRate = 0;        // processor_binaural only
+        double nsPerSample = 0.0;
+        double nsPerBlock = 0.0;
+        double realtimeFactor = 0.0;
+        juce::int64 samples = 0;
+        double bytesPerBlock = 0.0; // output_stage_* only
+        double extraSeconds = 0.0;  // prepare only (wall time)
+        int hrirTaps = 0;           // hrir_length only (at the engine sample rate)
+        double spectralErrorDb = 0.0, maxSpectralErrorDb = 0.0;
+        double bankBytes = 0.0;
+        double trackerLatencyP50Ms = 0.0, trackerLatencyP99Ms = 0.0, trackerLatencyMaxMs = 0.0;
+        double switchLatencyP50Ms = 0.0, switchLatencyP99Ms = 0.0, switchLatencyMaxMs = 0.0;
+        double maxGainError = -1.0; // pan_gains only
+
+        juce::var toVar() const
+        {
+            auto* o = new juce::DynamicObject();
+            o->setProperty ("name", name);
+            o->setProperty ("sampleRate", sampleRate);
+            o->setProperty ("blockSize", blockSize);
+
+            if (controlRate > 0)     o->setProperty ("controlRate", controlRate);
+            if (bytesPerBlock > 0.0) o->setProperty ("bytesPerBlock", bytesPerBlock);
+            if (bytesPerBlock > 0.0) o->setProperty ("gbPerSecond", bytesPerBlock / juce::jmax (1.0e-9, nsPerBlock));
+            if (extraSeconds > 0.0)  o->setProperty ("seconds", extraSeconds);
+
+            if (hrirTaps > 0)
+            {
+                o->setProperty ("hrirTaps", hrirTaps);
+                o->setProperty ("spectralErrorDb", spectralErrorDb);
+                o->setProperty ("maxSpectralErrorDb", maxSpectralErrorDb);
+                o->setProperty ("bankBytes", bankBytes);
+            }
+
+            if (trackerLatencyMaxMs > 0.0)
+            {
+                o->setProperty ("trackerLatencyP50Ms", trackerLatencyP50Ms);
+                o->setProperty ("trackerLatencyP99Ms", trackerLatencyP99Ms);
+                o->setProperty ("trackerLatencyMaxMs", trackerLatencyMaxMs);
+            }
+
+            if (switchLatencyMaxMs > 0.0)
+            {
+                o->setProperty ("switchLatencyP50Ms", switchLatencyP50Ms);
+                o->setProperty ("switchLatencyP99Ms", switchLatencyP99Ms);
+                o->setProperty ("switchLatencyMaxMs", switchLatencyMaxMs);
+            }
+
+            if (maxGainError >= 0.0)
+                o->setProperty ("maxGainError", maxGainError);
+
+            o->setProperty ("nsPerSample", nsPerSample);
+            o->setProperty ("nsPerBlock", nsPerBlock);
+            o->setProperty ("realtimeFactor", realtimeFactor);
+            o->setProperty ("samples", samples);
+            return juce::var (o);
+        }
+    };
+
+    double secondsSince (juce::int64 startTicks)
+    {
+        return juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+    }
+
+    Result makeResult (const juce::String& name, double sampleRate, int blockSize,
+                       juce::int64 samples, double seconds)
+    {
+        Result r;
+        r.name = name;
+        r.sampleRate = sampleRate;
+        r.blockSize = blockSize;
+        r.samples = samples;
+        r.nsPerSample = seconds * 1.0e9 / (double) juce::jmax ((juce::int64) 1, samples);
+        r.nsPerBlock = r.nsPerSample * blockSize;
+        r.realtimeFactor = ((double) samples / sampleRate) / juce::jmax (1.0e-12, seconds);
+        return r;
+    }
+
+    // Runs processBlock() until secondsPerCase of audio went through it
+    template <typename Fn>
+    Result measure (const juce::String& name, const Options& options,
+                    double sampleRate, int blockSize, Fn&& processOneBlock)
+    {
+        for (int i = 0; i < 4; ++i) // warm-up (caches, lazy init, first loads)
+            processOneBlock();
+
+        const auto target = (juce::int64) (options.secondsPerCase * sampleRate);
+        juce::int64 samples = 0;
+        int blocks = 0;
+
+        RealtimeGuard::ScopedAudioThread realtimeScope;
+        const auto start = juce::Time::getHighResolutionTicks();
+
+        while (samples < target || blocks < 8)
+        {
+            processOneBlock();
+            samples += blockSize;
+            ++blocks;
+        }
+
+        return makeResult (name, sampleRate, blockSize, samples, secondsSince (start));
+    }
+
+    juce::AudioBuffer<float> makeNoise (int numChannels, int numSamples)
+    {
+        juce::Random random (0x5eed);
+        juce::AudioBuffer<float> buffer (numChannels, numSamples);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (ch, i, random.nextFloat() * 0.5f - 0.25f);
+
+        return buffer;
+    }
+
+    // Host-side call (takes the listener lock), so it is exempt from the RT checks
+    void setParameter (BinauralPannerAudioProcessor& processor, const juce::String& id, float value)
+    {
+        RealtimeGuard::ScopedAllow hostSide;
+
+        if (auto* param = processor.apvts.getParameter (id))
+            param->setValueNotifyingHost (param->convertTo0to1 (value));
+    }
+
+    //==============================================================================
+    class Suite
+    {
+    public:
+        explicit Suite (Options o) : options (std::move (o)) {}
+
+        void run()
+        {
+            benchPanGains();
+
+            for (auto sampleRate : options.sampleRates)
+            {
+                benchPrepare (sampleRate);
+
+                for (auto blockSize : options.blockSizes)
+                {
+                    benchConvolverSteady (sampleRate, blockSize);
+                    benchConvolverDistance (sampleRate, blockSize);
+                    benchHeadModel (sampleRate, blockSize);
+                    benchSpeakerBed (sampleRate, blockSize);
+                    benchHrirLength (sampleRate, blockSize);
+                    benchConvolverCrossfade (sampleRate, blockSize);
+                    benchConvolverCellCrossings ("convolver_cell_crossings", 3.0f, sampleRate, blockSize);
+                    benchConvolverCellCrossings ("convolver_fast_sweep", 24.0f, sampleRate, blockSize);
+                    benchSwitchLatency (sampleRate, blockSize);
+                    benchBilinearSet (sampleRate, blockSize);
+                    benchJuceConvolution (sampleRate, blockSize);
+                    benchOutputStage (sampleRate, blockSize);
+                    benchProcessorStereo (sampleRate, blockSize);
+
+                    for (auto controlRate : options.controlRates)
+                        benchProcessorBinaural (sampleRate, blockSize, controlRate);
+
+                    benchHeadTracking (sampleRate, blockSize);
+                }
+            }
+        }
+
+        juce::var toJson() const
+        {
+            auto* meta = new juce::DynamicObject();
+            meta->setProperty ("juce", juce::SystemStats::getJUCEVersion());
+            meta->setProperty ("os", juce::SystemStats::getOperatingSystemName());
+            meta->setProperty ("cpu", juce::SystemStats::getCpuModel());
+            meta->setProperty ("numCpus", juce::SystemStats::getNumCpus());
+            meta->setProperty ("date", juce::Time::getCurrentTime().toISO8601 (true));
+           #if JUCE_DEBUG
+            meta->setProperty ("build", "Debug");
+           #else
+            meta->setProperty ("build", "Release");
+           #endif
+            meta->setProperty ("secondsPerCase", options.secondsPerCase);
+
+            juce::Array<juce::var> list;
+            for (const auto& r : results)
+                list.add (r.toVar());
+
+            auto* root = new juce::DynamicObject();
+            root->setProperty ("meta", juce::var (meta));
+            root->setProperty ("results", list);
+
+            if (! failures.isEmpty())
+                root->setProperty ("failures", failures);
+
+            return juce::var (root);
+        }
+
+        bool hasFailures() const noexcept { return ! failures.isEmpty(); }
+
+    private:
+        Options options;
+        std::vector<Result> results;
+        juce::StringArray failures; // cases that could not run or broke a check
+
+        void fail (const juce::String& message)
+        {
+            std::cerr << message << "\n";
+            failures.add (message);
+        }
+
+        bool wants (const juce::String& name) const
+        {
+            return options.only.isEmpty() || name.contains (options.only);
+        }
+
+        void add (Result r)
+        {
+            std::cerr << r.name << " sr=" << r.sampleRate << " bs=" << r.blockSize;
+            if (r.controlRate > 0) std::cerr << " cr=" << r.controlRate;
+            std::cerr << ": " << r.nsPerSample << " ns/sample, " << r.realtimeFactor << "x realtime\n";
+
+            results.push_back (std::move (r));
+        }
+
+        //==============================================================================
+        // Equal-power pan law through FastMathApproximations (the processor's per-sample
+        // ramp) against std::cos/std::sin in float: worst gain error over the pan range
+        // against the exact law, and ns per gain pair (nsPerSample)
+        void benchPanGains()
+        {
+            if (! wants ("pan_gains"))
+                return;
+
+            constexpr int numPans = 1 << 20;
+            const float quarterPi = 0.25f * juce::MathConstants<float>::pi;
+
+            for (const bool fast : { true, false })
+            {
+                double maxError = 0.0, sum = 0.0;
+                const auto start = juce::Time::getHighResolutionTicks();
+
+                for (int i = 0; i <= numPans; ++i)
+                {
+                    const float pan = -1.0f + 2.0f * (float) i / (float) numPans;
+                    const float angle = (pan + 1.0f) * quarterPi;
+                    const float gainL = fast ? juce::dsp::FastMathApproximations::cos (angle) : std::cos (angle);
+                    const float gainR = fast ? juce::dsp::FastMathApproximations::sin (angle) : std::sin (angle);
+                    sum += gainL + gainR;
+
+                    const double exact = ((double) pan + 1.0) * 0.25 * juce::MathConstants<double>::pi;
+                    maxError = juce::jmax (maxError, std::abs (gainL - std::cos (exact)), std::abs (gainR - std::sin (exact)));
+                }
+
+                const auto seconds = secondsSince (start);
+
+                Result r;
+                r.name = fast ? "pan_gains_fast" : "pan_gains_std";
+                r.samples = numPans + 1;
+                r.nsPerSample = seconds * 1.0e9 / (double) r.samples;
+                r.maxGainError = maxError;
+                add (r);
+
+                if (sum < 0.0) // keeps the loop from being optimised away
+                    std::cerr << sum;
+            }
+        }
+
+        // Cache-build time: decode + resample the whole HRIR bank, then a repeated prepare
+        void benchPrepare (double sampleRate)
+        {
+            if (! wants ("prepare"))
+                return;
+
+            BinauralConvolver convolver;
+            const auto start = juce::Time::getHighResolutionTicks();
+            convolver.prepare (sampleRate, 512);
+            convolver.initialiseAtPositionDegrees (0.0f, 0.0f);
+
+            Result r;
+            r.name = "prepare";
+            r.sampleRate = sampleRate;
+            r.blockSize = 512;
+            r.extraSeconds = secondsSince (start);
+            add (r);
+
+            // What a host's repeated prepareToPlay costs with unchanged settings
+            const auto repeatStart = juce::Time::getHighResolutionTicks();
+            convolver.prepare (sampleRate, 512);
+            convolver.initialiseAtPositionDegrees (0.0f, 0.0f);
+
+            r.name = "prepare_repeat";
+            r.extraSeconds = secondsSince (repeatStart);
+            add (r);
+        }
+
+        // One position inside a cell, fractions moving slightly every block
+        void benchConvolverSteady (double sampleRate, int blockSize)
+        {
+            if (! wants ("convolver_steady"))
+                return;
+
+            BinauralConvolver convolver;
+            convolver.prepare (sampleRate, blockSize);
+            convolver.initialiseAtPositionDegrees (12.0f, 4.0f);
+
+            auto input = makeNoise (1, blockSize);
+            juce::AudioBuffer<float> out (2, blockSize);
+            float az = 12.0f, dir = 0.01f;
+
+            add (measure ("convolver_steady", options, sampleRate, blockSize, [&]
+            {
+                az += dir;
+                if (az > 18.0f || az < 12.0f) dir = -dir;
+
+                convolver.setPositionDegrees (az, 4.0f);
+                convolver.processAndAdd (input.getReadPointer (0), out.getWritePointer (0), out.getWritePointer (1), blockSize);
+            }));
+        }
+
+        // convolver_steady with distance automation (0.3 .. 10 m) through the output stage
+        void benchConvolverDistance (double sampleRate, int blockSize)
+        {
+            if (! wants ("convolver_distance"))
+                return;
+
+            BinauralConvolver convolver;
+            convolver.prepare (sampleRate, blockSize);
+            convolver.initialiseAtPositionDegrees (12.0f, 4.0f);
+
+            auto input = makeNoise (1, blockSize);
+            juce::AudioBuffer<float> out (2, blockSize);
+            float az = 12.0f, dir = 0.01f;
+            float distance = 0.3f, distanceRatio = 1.01f;
+
+            add (measure ("convolver_distance", options, sampleRate, blockSize, [&]
+            {
+                az += dir;
+                if (az > 18.0f || az < 12.0f) dir = -dir;
+
+                distance *= distanceRatio;
+                if (distance > 10.0f || distance < 0.3f) distanceRatio = 1.0f / distanceRatio;
+
+                convolver.setPositionDegrees (az, 4.0f);
+                convolver.setDistance (distance);
+                convolver.processAndAdd (input.getReadPointer (0), out.getWritePointer (0), out.getWritePointer (1), blockSize);
+            }));
+        }
+
+        // convolver_steady at several HRIR lengths, with the bank's spectral error
+        void benchHrirLength (double sampleRate, int blockSize)
+        {
+            if (! wants ("hrir_length"))
+                return;
+
+            for (int taps : { 32, 64, 96, 128, 0 })
+            {
+                BinauralConvolver convolver;
+                convolver.setHrirLength (taps);
+                convolver.prepare (sampleRate, blockSize);
+                convolver.initialiseAtPositionDegrees (12.0f, 4.0f);
+
+                auto input = makeNoise (1, blockSize);
+                juce::AudioBuffer<float> out (2, blockSize);
+                float az = 12.0f, dir = 0.01f;
+
+                auto r = measure ("hrir_length", options, sampleRate, blockSize, [&]
+                {
+                    az += dir;
+                    if (az > 18.0f || az < 12.0f) dir = -dir;
+
+                    convolver.setPositionDegrees (az, 4.0f);
+                    convolver.processAndAdd (input.getReadPointer (0), out.getWritePointer (0), out.getWritePointer (1), blockSize);
+                });
+
+                const auto& report = convolver.getHrirBankReport();
+                r.hrirTaps = report.taps;
+                r.spectralErrorDb = report.meanSpectralErrorDb;
+                r.maxSpectralErrorDb = report.maxSpectralErrorDb;
+                r.bankBytes = (double) report.memoryBytes;
+                add (r);
+            }
+        }
+
+        // Parametric head model, same moving position as convolver_steady
+        void benchHeadModel (double sampleRate, int blockSize)
+        {
+            if (! wants ("head_model"))
+                return;
+
+            SphericalHeadModel model;
+            model.prepare (sampleRate);
+            model.initialiseAtPositionDegrees (12.0f, 4.0f);
+
+            auto input = makeNoise (1, blockSize);
+            juce::AudioBuffer<float> out (2, blockSize);
+            float az = 12.0f, dir = 0.01f;
+
+            add (measure ("head_model", options, sampleRate, blockSize, [&]
+            {
+                az += dir;
+                if (az > 18.0f || az < 12.0f) dir = -dir;
+
+                model.setPositionDegrees (az, 4.0f);
+                model.processAndAdd (input.getReadPointer (0), out.getWritePointer (0), out.getWritePointer (1), blockSize);
+            }));
+        }
+
+        // 7.1.4 bed rendered through the static virtual speakers
+        void benchSpeakerBed (double sampleRate, int blockSize)
+        {
+            if (! wants ("speaker_bed"))
+                return;
+
+            BinauralConvolver bank;
+            bank.prepare (sampleRate, blockSize);
+
+            const auto layout = juce::AudioChannelSet::create7point1point4();
+            SpeakerBedRenderer bed;
+            bed.prepare (layout, bank, sampleRate, blockSize);
+
+            auto input = makeNoise (layout.size(), blockSize);
+            juce::AudioBuffer<float> buffer (layout.size(), blockSize);
+
+            add (measure ("speaker_bed", options, sampleRate, blockSize, [&]
+            {
+                for (int ch = 0; ch < layout.size(); ++ch)
+                    buffer.copyFrom (ch, 0, input, ch, 0, blockSize);
+
+                bed.process (buffer, 0, blockSize);
+            }));
+        }
+
+        // Only blocks processed while a crossfade is running are timed. 5 <-> 15 degrees
+        // crosses one azimuth boundary: the cells share the az 10 corners, so 6 corner pairs run.
+        void benchConvolverCrossfade (double sampleRate, int blockSize)
+        {
+            if (! wants ("convolver_crossfade"))
+                return;
+
+            BinauralConvolver convolver;
+            convolver.prepare (sampleRate, blockSize);
+            convolver.initialiseAtPositionDegrees (5.0f, 5.0f);
+
+            auto input = makeNoise (1, blockSize);
+            juce::AudioBuffer<float> out (2, blockSize);
+
+            const auto target = (juce::int64) (options.secondsPerCase * sampleRate);
+            juce::int64 samples = 0;
+            double seconds = 0.0;
+            bool flip = false;
+
+            while (samples < target)
+            {
+                flip = ! flip;
+                convolver.setPositionDegrees (flip ? 15.0f : 5.0f, 5.0f);
+
+                // Every switch must start a crossfade, or nothing below advances
+                if (! convolver.waitForPendingLoad (2000) || ! BinauralBenchmarkAccess::isCrossfading (convolver))
+                {
+                    fail ("convolver_crossfade: cell switch did not start a crossfade");
+                    return;
+                }
+
+                // drain the crossfade, timing every block that is part of it
+                while (BinauralBenchmarkAccess::isCrossfading (convolver))
+                {
+                    RealtimeGuard::ScopedAudioThread realtimeScope;
+                    const auto start = juce::Time::getHighResolutionTicks();
+                    convolver.processAndAdd (input.getReadPointer (0), out.getWritePointer (0), out.getWritePointer (1), blockSize);
+                    seconds += secondsSince (start);
+                    samples += blockSize;
+                }
+            }
+
+            add (makeResult ("convolver_crossfade", sampleRate, blockSize, samples, seconds));
+        }
+
+        // Sweeps back and forth across the full azimuth range. At 24 degrees per 1024 samples
+        // a cell lasts well under a 30 ms crossfade, so several cells overlap (chained crossfades).
+        void benchConvolverCellCrossings (const juce::String& name, float degreesPer1024,
+                                          double sampleRate, int blockSize)
+        {
+            if (! wants (name))
+                return;
+
+            BinauralConvolver convolver;
+            convolver.prepare (sampleRate, blockSize);
+            convolver.initialiseAtPositionDegrees (-90.0f, 0.0f);
+
+            auto input = makeNoise (1, blockSize);
+            juce::AudioBuffer<float> out (2, blockSize);
+            const float step = degreesPer1024 * (float) blockSize / 1024.0f;
+            float az = -90.0f, dir = step;
+
+            add (measure (name, options, sampleRate, blockSize, [&]
+            {
+                az += dir;
+                if (az > 90.0f || az < -90.0f) dir = -dir;
+
+                convolver.setPositionDegrees (az, 0.0f);
+                convolver.processAndAdd (input.getReadPointer (0), out.getWritePointer (0), out.getWritePointer (1), blockSize);
+            }));
+        }
+
+        // Request-to-audible latency of cell switches, in real time: blocks are paced like a
+        // device callback and the source steps to the next cell every 50 ms. Measured from
+        // setPositionDegrees() to the block in which the new cell starts to fade in.
+        void benchSwitchLatency (double sampleRate, int blockSize)
+        {
+            if (! wants ("convolver_switch_latency"))
+                return;
+
+            EngineTelemetry telemetry;
+            BinauralConvolver convolver;
+            convolver.setTelemetry (&telemetry);
+            convolver.prepare (sampleRate, blockSize);
+            convolver.initialiseAtPositionDegrees (-85.0f, 5.0f);
+
+            auto input = makeNoise (1, blockSize);
+            juce::AudioBuffer<float> out (2, blockSize);
+
+            const double stepInterval = 0.05;
+            const auto target = (juce::int64) (options.secondsPerCase * sampleRate);
+            const auto startTicks = juce::Time::getHighResolutionTicks();
+            juce::int64 samples = 0;
+            double nextStep = stepInterval, processSeconds = 0.0;
+            float az = -85.0f, dir = 10.0f;
+
+            while (samples < target)
+            {
+                if (secondsSince (startTicks) >= nextStep)
+                {
+                    az += dir;
+                    if (az > 85.0f || az < -85.0f)
+                    {
+                        dir = -dir;
+                        az += 2.0f * dir;
+                    }
+
+                    convolver.setPositionDegrees (az, 5.0f);
+                    nextStep += stepInterval;
+                }
+
+                const auto blockStart = juce::Time::getHighResolutionTicks();
+                convolver.processAndAdd (input.getReadPointer (0), out.getWritePointer (0), out.getWritePointer (1), blockSize);
+                processSeconds += secondsSince (blockStart);
+                samples += blockSize;
+
+                // wait for the next device callback
+                const double wait = (double) samples / sampleRate - secondsSince (startTicks);
+                if (wait > 0.0)
+                    juce::Thread::sleep ((int) (wait * 1000.0));
+            }
+
+            juce::Thread::sleep (250); // let the telemetry collector drain the last events
+
+            const auto snapshot = telemetry.getSnapshot();
+
+            auto r = makeResult ("convolver_switch_latency", sampleRate, blockSize, samples, processSeconds);
+            r.switchLatencyP50Ms = snapshot.switchLatency.percentileMicroseconds (0.5) / 1000.0;
+            r.switchLatencyP99Ms = snapshot.switchLatency.percentileMicroseconds (0.99) / 1000.0;
+            r.switchLatencyMaxMs = snapshot.switchLatency.percentileMicroseconds (1.0) / 1000.0;
+            add (r);
+        }
+
+        // The 4 corner convolutions of one set, without mixing
+        void benchBilinearSet (double sampleRate, int blockSize)
+        {
+            if (! wants ("bilinear_set"))
+                return;
+
+            BinauralConvolver convolver;
+            convolver.prepare (sampleRate, blockSize);
+            convolver.initialiseAtPositionDegrees (12.0f, 4.0f);
+
+            auto input = makeNoise (1, blockSize);
+
+            add (measure ("bilinear_set", options, sampleRate, blockSize, [&]
+            {
+                BinauralBenchmarkAccess::processSetA (convolver, input.getReadPointer (0), blockSize);
+            }));
+        }
+
+        // Reference backend: one juce::dsp::Convolution with a 200-tap IR at 44.1 kHz
+        // (scaled with the sample rate), i.e. one ear of one corner
+        void benchJuceConvolution (double sampleRate, int blockSize)
+        {
+            if (! wants ("backend_juce_convolution"))
+                return;
+
+            juce::dsp::Convolution convolution;
+            convolution.prepare ({ sampleRate, (juce::uint32) blockSize, 1 });
+
+            const int irLength = (int) std::ceil (200.0 * sampleRate / 44100.0);
+            auto ir = makeNoise (1, irLength);
+            convolution.loadImpulseResponse (std::move (ir), sampleRate,
+                                             juce::dsp::Convolution::Stereo::no,
+                                             juce::dsp::Convolution::Trim::no,
+                                             juce::dsp::Convolution::Normalise::no);
+
+            auto input = makeNoise (1, blockSize);
+            juce::AudioBuffer<float> out (1, blockSize);
+
+            // let the background thread install the IR
+            for (int i = 0; i < 50 && convolution.getCurrentIRSize() != irLength; ++i)
+                juce::Thread::sleep (10);
+
+            add (measure ("backend_juce_convolution", options, sampleRate, blockSize, [&]
+            {
+                const float* inChannels[] = { input.getReadPointer (0) };
+                float* outChannels[] = { out.getWritePointer (0) };
+                const juce::dsp::AudioBlock<const float> inBlock (inChannels, 1, (size_t) blockSize);
+                juce::dsp::AudioBlock<float> outBlock (outChannels, 1, (size_t) blockSize);
+                convolution.process (juce::dsp::ProcessContextNonReplacing<float> (inBlock, outBlock));
+            }));
+        }
+
+        // Memory traffic of the processor's output stage, convolutions excluded.
+        // legacy: the pre-process-and-add path (copy in, clear temps, copy out + add)
+        // fused:  copy in, clear output, accumulate in place
+        void benchOutputStage (double sampleRate, int blockSize)
+        {
+            const auto bytes = [blockSize] (int floatPasses) { return (double) floatPasses * blockSize * (double) sizeof (float); };
+
+            auto io = makeNoise (2, blockSize);
+            auto mixed = makeNoise (2, blockSize); // stands in for a set mix
+            juce::AudioBuffer<float> monoL (1, blockSize), monoR (1, blockSize);
+            juce::AudioBuffer<float> outL (2, blockSize), outR (2, blockSize);
+
+            if (wants ("output_stage_legacy"))
+            {
+                auto r = measure ("output_stage_legacy", options, sampleRate, blockSize, [&]
+                {
+                    monoL.copyFrom (0, 0, io, 0, 0, blockSize);
+                    monoR.copyFrom (0, 0, io, 1, 0, blockSize);
+                    outL.clear();
+                    outR.clear();
+
+                    for (int ch = 0; ch < 2; ++ch)
+                    {
+                        outL.copyFrom (ch, 0, mixed, ch, 0, blockSize);
+                        outR.copyFrom (ch, 0, mixed, ch, 0, blockSize);
+                    }
+
+                    io.copyFrom (0, 0, outL, 0, 0, blockSize);
+                    io.addFrom  (0, 0, outR, 0, 0, blockSize);
+                    io.copyFrom (1, 0, outL, 1, 0, blockSize);
+                    io.addFrom  (1, 0, outR, 1, 0, blockSize);
+                });
+
+                // reads + writes of every pass above, in floats per channel-block
+                r.bytesPerBlock = bytes (2 * 2 + 4 + 4 * 2 + 2 * 2 + 2 * 3);
+                add (r);
+            }
+
+            if (wants ("output_stage_fused"))
+            {
+                auto r = measure ("output_stage_fused", options, sampleRate, blockSize, [&]
+                {
+                    monoL.copyFrom (0, 0, io, 0, 0, blockSize);
+                    monoR.copyFrom (0, 0, io, 1, 0, blockSize);
+
+                    for (int ch = 0; ch < 2; ++ch)
+                    {
+                        auto* out = io.getWritePointer (ch);
+                        juce::FloatVectorOperations::clear (out, blockSize);
+                        juce::FloatVectorOperations::add (out, mixed.getReadPointer (ch), blockSize);
+                        juce::FloatVectorOperations::add (out, mixed.getReadPointer (ch), blockSize);
+                    }
+                });
+
+                r.bytesPerBlock = bytes (2 * 2 + 2 + 2 * 3 * 2);
+                add (r);
+            }
+        }
+
+        // Stereo mode: static position and a continuously ramping one
+        void benchProcessorStereo (double sampleRate, int blockSize)
+        {
+            for (const bool moving : { false, true })
+            {
+                const juce::String name = moving ? "processor_stereo_moving" : "processor_stereo_static";
+
+                if (! wants (name))
+                    continue;
+
+                BinauralPannerAudioProcessor processor;
+                processor.setQualityGovernorEnabled (false); // measure the full-quality path
+                setParameter (processor, "mode", 0.0f);
+                processor.setPlayConfigDetails (2, 2, sampleRate, blockSize);
+                processor.prepareToPlay (sampleRate, blockSize);
+
+                auto buffer = makeNoise (2, blockSize);
+                juce::MidiBuffer midi;
+                float az = 0.0f;
+
+                add (measure (name, options, sampleRate, blockSize, [&]
+                {
+                    if (moving)
+                    {
+                        az = az > 80.0f ? -80.0f : az + 1.0f;
+                        setParameter (processor, "azimuth", az);
+                    }
+
+                    processor.processBlock (buffer, midi);
+                }));
+            }
+        }
+
+        // Binaural mode at a given control rate (sub-block size), slowly moving source
+        void benchProcessorBinaural (double sampleRate, int blockSize, int controlRate)
+        {
+            if (! wants ("processor_binaural"))
+                return;
+
+            BinauralPannerAudioProcessor processor;
+            processor.setQualityGovernorEnabled (false); // measure the full-quality path
+            setParameter (processor, "mode", 1.0f);
+            processor.setControlBlockSize (controlRate);
+            processor.setPlayConfigDetails (2, 2, sampleRate, blockSize);
+            processor.prepareToPlay (sampleRate, blockSize);
+
+            auto buffer = makeNoise (2, blockSize);
+            juce::MidiBuffer midi;
+            float az = 0.0f;
+
+            auto r = measure ("processor_binaural", options, sampleRate, blockSize, [&]
+            {
+                az = az > 40.0f ? -40.0f : az + 0.05f;
+                setParameter (processor, "azimuth", az);
+                processor.processBlock (buffer, midi);
+            });
+
+            r.controlRate = controlRate;
+            add (r);
+        }
+
+        // Tracker packet -> rendered, through the real UDP path: a stand-in sender on
+        // localhost sends OSC /head/ypr at 100 Hz while blocks are processed at the pace of
+        // a real device. Latency percentiles come from the processor's own telemetry.
+        void benchHeadTracking (double sampleRate, int blockSize)
+        {
+            if (! wants ("head_tracking"))
+                return;
+
+            BinauralPannerAudioProcessor processor;
+            processor.setQualityGovernorEnabled (false);
+            setParameter (processor, "mode", 1.0f);
+            processor.setPlayConfigDetails (2, 2, sampleRate, blockSize);
+            processor.prepareToPlay (sampleRate, blockSize);
+
+            if (! processor.setHeadTrackerListening (true, 0)) // any free port
+            {
+                std::cerr << "head_tracking: cannot bind a UDP port\n";
+                return;
+            }
+
+            juce::DatagramSocket sender;
+            const int port = processor.getHeadTracker().getListeningPort();
+
+            auto buffer = makeNoise (2, blockSize);
+            juce::MidiBuffer midi;
+
+            const double packetInterval = 0.01;
+            const auto target = (juce::int64) (options.secondsPerCase * sampleRate);
+            const auto startTicks = juce::Time::getHighResolutionTicks();
+            juce::int64 samples = 0;
+            double nextPacket = 0.0, processSeconds = 0.0;
+            float yaw = 0.0f;
+
+            while (samples < target)
+            {
+                const double now = secondsSince (startTicks);
+
+                while (nextPacket <= now)
+                {
+                    yaw = yaw > 60.0f ? -60.0f : yaw + 1.0f;
+                    const auto packet = makeOscYpr (yaw, 0.0f, 0.0f);
+                    sender.write ("127.0.0.1", port, packet.getData(), (int) packet.getSize());
+                    nextPacket += packetInterval;
+                }
+
+                const auto blockStart = juce::Time::getHighResolutionTicks();
+                processor.processBlock (buffer, midi);
+                processSeconds += secondsSince (blockStart);
+                samples += blockSize;
+
+                // wait for the next device callback
+                const double wait = (double) samples / sampleRate - secondsSince (startTicks);
+                if (wait > 0.0)
+                    juce::Thread::sleep ((int) (wait * 1000.0));
+            }
+
+            processor.setHeadTrackerListening (false);
+            juce::Thread::sleep (250); // let the telemetry collector drain the last events
+
+            auto* telemetry = processor.getTelemetry();
+
+            if (telemetry == nullptr)
+            {
+                fail ("head_tracking: the binaural engine is not loaded");
+                return;
+            }
+
+            const auto snapshot = telemetry->getSnapshot();
+
+            auto r = makeResult ("head_tracking", sampleRate, blockSize, samples, processSeconds);
+            r.trackerLatencyP50Ms = snapshot.trackerLatency.percentileMicroseconds (0.5) / 1000.0;
+            r.trackerLatencyP99Ms = snapshot.trackerLatency.percentileMicroseconds (0.99) / 1000.0;
+            r.trackerLatencyMaxMs = snapshot.trackerLatency.percentileMicroseconds (1.0) / 1000.0;
+            r.controlRate = processor.getControlBlockSize();
+            add (r);
+        }
+
+        // OSC message "/head/ypr" ,fff
+        static juce::MemoryBlock makeOscYpr (float yaw, float pitch, float roll)
+        {
+            juce::MemoryOutputStream out;
+            out.write ("/head/ypr\0\0\0", 12);
+            out.write (",fff\0\0\0\0", 8);
+
+            for (float v : { yaw, pitch, roll })
+            {
+                juce::uint32 bits;
+                std::memcpy (&bits, &v, sizeof (bits));
+                out.writeIntBigEndian ((int) bits);
+            }
+
+            return out.getMemoryBlock();
+        }
+    };
+
+    juce::Array<double> parseDoubles (const juce::String& text)
+    {
+        juce::Array<double> values;
+        for (auto& t : juce::StringArray::fromTokens (text, ",", ""))
+            values.add (t.getDoubleValue());
+        return values;
+    }
+
+    juce::Array<int> parseInts (const juce::String& text)
+    {
+        juce::Array<int> values;
+        for (auto& t : juce::StringArray::fromTokens (text, ",", ""))
+            values.add (t.getIntValue());
+        return values;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    juce::ArgumentList args (argc, argv);
+
+    if (args.containsOption ("--help|-h"))
+    {
+        std::cout << "BinauralBench [--quick] [--seconds <s>] [--rates 44100,48000]\n"
+                     "              [--blocks 16,...,4096] [--control-rates 16,...,256]\n"
+                     "              [--only <name substring>] [--out results.json]\n";
+        return 0;
+    }
+
+    Options options;
+
+    if (args.containsOption ("--quick"))
+    {
+        options.secondsPerCase = 0.25;
+        options.sampleRates = { 48000.0 };
+        options.blockSizes = { 32, 256, 2048 };
+        options.controlRates = { 32, 64 };
+    }
+
+    if (args.containsOption ("--seconds"))       options.secondsPerCase = args.getValueForOption ("--seconds").getDoubleValue();
+    if (args.containsOption ("--rates"))         options.sampleRates = parseDoubles (args.getValueForOption ("--rates"));
+    if (args.containsOption ("--blocks"))        options.blockSizes = parseInts (args.getValueForOption ("--blocks"));
+    if (args.containsOption ("--control-rates")) options.controlRates = parseInts (args.getValueForOption ("--control-rates"));
+    if (args.containsOption ("--only"))          options.only = args.getValueForOption ("--only");
+
+    Suite suite (options);
+    suite.run();
+
+    const auto json = juce::JSON::toString (suite.toJson());
+
+    if (args.containsOption ("--out"))
+    {
+        const auto file = args.getFileForOption ("--out");
+
+        if (! file.replaceWithText (json))
+        {
+            std::cerr << "cannot write " << file.getFullPathName() << "\n";
+            return 1;
+        }
+    }
+    else
+    {
+        std::cout << json << "\n";
+    }
+
+    return suite.hasFailures() ? 1 : 0;
+}
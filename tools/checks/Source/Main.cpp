@@ -0,0 +1,500 @@
+/*
+  ==============================================================================
+
+    BinauralChecks - regression checks for the engine's stateful paths.
+
+    Each check drives BinauralPannerAudioProcessor (without the editor) through
+    one transition - a locate, an engine release, mode switches, lookahead, a
+    warm-up - and compares its output with a render that never went through it.
+    Prints one line per check; the exit code is 1 if any fails.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+
+#include <iostream>
+
+//==============================================================================
+// Reaches the engine's convolvers (declared friend in BinauralPannerAudioProcessor)
+struct BinauralCheckAccess
+{
+    // The convolvers may be heard (loaded and warmed up)
+    static bool isEngineWarm (const BinauralPannerAudioProcessor& p) { return p.engine != nullptr && p.engineWarm; }
+
+    static BinauralConvolver& getConvolver (BinauralPannerAudioProcessor& p, bool right)
+    {
+        return right ? p.engine->hrirSrcR : p.engine->hrirSrcL;
+    }
+};
+
+namespace
+{
+    //==============================================================================
+    constexpr double checkSampleRate = 48000.0;
+    constexpr int checkBlockSize = 512;
+    constexpr int checkBlockSizes[] { 32, 512, 2048 }; // lookahead / warm-up checks
+    constexpr double checkTonesHz[2] { 220.0, 330.0 }; // L, R
+    constexpr int checkSettleSamples = 4800;          // filters starting from silence
+
+    void setParameter (BinauralPannerAudioProcessor& processor, const juce::String& id, float value)
+    {
+        if (auto* param = processor.apvts.getParameter (id))
+            param->setValueNotifyingHost (param->convertTo0to1 (value));
+    }
+
+    // Binaural at the given azimuth, no engine switches of the governor's own
+    void prepareForCheck (BinauralPannerAudioProcessor& processor, float azimuth,
+                          double sampleRate = checkSampleRate, int blockSize = checkBlockSize)
+    {
+        processor.setQualityGovernorEnabled (false);
+        processor.setPlayConfigDetails (2, 2, sampleRate, blockSize);
+        setParameter (processor, "mode", 1.0f);
+        setParameter (processor, "azimuth", azimuth);
+        processor.prepareToPlay (sampleRate, blockSize);
+    }
+
+    // A steady tone per channel: every step in the output is the engine's
+    juce::AudioBuffer<float> makeTones (double seconds)
+    {
+        const int numSamples = (int) (seconds * checkSampleRate);
+        juce::AudioBuffer<float> input (2, numSamples);
+
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                input.setSample (ch, i, 0.25f * (float) std::sin (juce::MathConstants<double>::twoPi * checkTonesHz[ch] * i / checkSampleRate));
+
+        return input;
+    }
+
+    juce::AudioBuffer<float> makeNoise (int numSamples)
+    {
+        juce::Random random (0x5eed);
+        juce::AudioBuffer<float> buffer (2, numSamples);
+
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (ch, i, random.nextFloat() * 0.5f - 0.25f);
+
+        return buffer;
+    }
+
+    // Calls renderBlock (start, numSamples) for consecutive blocks; paced ones at the speed
+    // of a device callback, so the worker pool and the engine timer keep up as in a host
+    void renderBlocks (int numSamples, int blockSize, double sampleRate, bool paced,
+                       const std::function<void (int, int)>& renderBlock)
+    {
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+
+        for (int pos = 0; pos < numSamples; pos += blockSize)
+        {
+            const int n = juce::jmin (blockSize, numSamples - pos);
+            renderBlock (pos, n);
+
+            if (! paced)
+                continue;
+
+            const double elapsed = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+            const double wait = (pos + n) / sampleRate - elapsed;
+
+            if (wait > 0.0)
+                juce::Thread::sleep ((int) (wait * 1000.0));
+        }
+    }
+
+    void processInPlace (BinauralPannerAudioProcessor& processor, juce::AudioBuffer<float>& buffer, int start, int numSamples)
+    {
+        juce::AudioBuffer<float> io (buffer.getArrayOfWritePointers(), 2, start, numSamples);
+        juce::MidiBuffer midi;
+        processor.processBlock (io, midi);
+    }
+
+    //==============================================================================
+    // output[i + outputOffset] against reference[i] over range: the largest error and the
+    // first / last reference position where it exceeds the tolerance (-1: nowhere)
+    struct Difference
+    {
+        double maxError = 0.0;
+        int first = -1, last = -1;
+
+        bool matches() const noexcept { return first < 0; }
+    };
+
+    Difference compare (const juce::AudioBuffer<float>& output, const juce::AudioBuffer<float>& reference,
+                        juce::Range<int> range, double tolerance, int outputOffset = 0)
+    {
+        Difference d;
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            for (int i = range.getStart(); i < range.getEnd(); ++i)
+            {
+                const double error = std::abs ((double) output.getSample (ch, i + outputOffset) - reference.getSample (ch, i));
+                d.maxError = juce::jmax (d.maxError, error);
+
+                if (error > tolerance)
+                {
+                    d.first = d.first < 0 ? i : juce::jmin (d.first, i);
+                    d.last = juce::jmax (d.last, i);
+                }
+            }
+        }
+
+        return d;
+    }
+
+    // The last quarter second: where every transition has finished
+    Difference compareTail (const juce::AudioBuffer<float>& output, const juce::AudioBuffer<float>& reference)
+    {
+        const int end = output.getNumSamples();
+        return compare (output, reference, { end - (int) (0.25 * checkSampleRate), end }, 1.0e-4);
+    }
+
+    // A click: a second difference beyond what a smooth tone at the output's peak level can
+    // reach (10x, at the higher tone). First such sample from `from` on, outside `skip`, or -1.
+    int findClick (const juce::AudioBuffer<float>& output, int from, juce::Range<int> skip = {})
+    {
+        const double w = juce::MathConstants<double>::twoPi * checkTonesHz[1] / checkSampleRate;
+        int first = -1;
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            const float* y = output.getReadPointer (ch);
+            const double limit = 10.0 * w * w * output.getMagnitude (ch, 0, output.getNumSamples());
+
+            for (int i = juce::jmax (2, from); i < output.getNumSamples(); ++i)
+            {
+                if (! skip.contains (i) && std::abs ((double) y[i] - 2.0 * y[i - 1] + y[i - 2]) > limit)
+                {
+                    first = first < 0 ? i : juce::jmin (first, i);
+                    break;
+                }
+            }
+        }
+
+        return first;
+    }
+
+    // Playing; the check moves timeInSamples (a jump is a locate)
+    struct LocatingPlayHead : juce::AudioPlayHead
+    {
+        juce::int64 timeInSamples = 0;
+
+        juce::Optional<PositionInfo> getPosition() const override
+        {
+            PositionInfo info;
+            info.setIsPlaying (true);
+            info.setTimeInSamples (timeInSamples);
+            return info;
+        }
+    };
+
+    //==============================================================================
+    // Each check returns what failed, or an empty string.
+
+    // The host locates while playing, to where the azimuth automation is on the other side.
+    // The new cell must be heard from the locate on without a fade from the old one (the
+    // output is that of a render that was there all along), and nothing else may click.
+    juce::String checkSeek()
+    {
+        auto output = makeTones (2.0);
+        auto reference = output;
+        const int locate = 64 * checkBlockSize;
+
+        BinauralPannerAudioProcessor processor, atTarget;
+        LocatingPlayHead playHead;
+        processor.setPlayHead (&playHead);
+        prepareForCheck (processor, -60.0f);
+        prepareForCheck (atTarget, 60.0f);
+
+        renderBlocks (output.getNumSamples(), checkBlockSize, checkSampleRate, true, [&] (int start, int n)
+        {
+            if (start == locate)
+            {
+                playHead.timeInSamples += 10 * (juce::int64) checkSampleRate;
+                setParameter (processor, "azimuth", 60.0f);
+            }
+
+            processInPlace (processor, output, start, n);
+            processInPlace (atTarget, reference, start, n);
+            playHead.timeInSamples += n;
+        });
+
+        processor.setPlayHead (nullptr);
+
+        const auto d = compare (output, reference, { locate, output.getNumSamples() }, 1.0e-4);
+        const int matchesFrom = d.matches() ? locate : d.last + 1;
+
+        if (matchesFrom > locate + checkBlockSize)
+            return "the new position was heard " + juce::String (matchesFrom - locate)
+                   + " samples after the locate, not within its block";
+
+        const int click = findClick (output, checkSettleSamples, { locate, matchesFrom + 2 });
+
+        if (click >= 0)
+            return "click at sample " + juce::String (click);
+
+        return {};
+    }
+
+    // Binaural, then Stereo for longer than the release delay: the engine must be released
+    // (its timer frees it), then built again on the worker pool when Binaural comes back,
+    // with the head model standing in meanwhile. By the end the output must be the
+    // convolvers' again (that of a render that stayed in Binaural), and no step may click.
+    juce::String checkEngineRelease()
+    {
+        auto output = makeTones (5.0);
+        auto reference = output;
+        const int toStereo = 96 * checkBlockSize;        // ~1 s
+        const int backToBinaural = 240 * checkBlockSize; // ~2.6 s
+        bool released = false;
+
+        BinauralPannerAudioProcessor processor, stayed;
+        processor.setEngineReleaseDelay (0.5);
+        prepareForCheck (processor, 30.0f);
+        prepareForCheck (stayed, 30.0f);
+
+        renderBlocks (output.getNumSamples(), checkBlockSize, checkSampleRate, true, [&] (int start, int n)
+        {
+            if (start == toStereo)       setParameter (processor, "mode", 0.0f);
+            if (start == backToBinaural) setParameter (processor, "mode", 1.0f);
+
+            if (start > toStereo && start < backToBinaural)
+                released = released || ! processor.isBinauralEngineLoaded();
+
+            processInPlace (processor, output, start, n);
+            processInPlace (stayed, reference, start, n);
+        });
+
+        if (! released)
+            return "the engine was not released while Stereo played past its release delay";
+
+        if (! processor.isBinauralEngineLoaded())
+            return "the engine was not built again";
+
+        const auto d = compareTail (output, reference);
+
+        if (! d.matches())
+            return "the rebuilt engine is not heard by the end (sample " + juce::String (d.first) + ")";
+
+        const int click = findClick (output, checkSettleSamples);
+
+        if (click >= 0)
+            return "click at sample " + juce::String (click);
+
+        return {};
+    }
+
+    // Binaural -> Head Model renderer -> HRIR -> Stereo -> Binaural, about 0.6 s each. The
+    // engine stays loaded (warm standby) and its convolvers are warmed up before each
+    // return to them: every switch is a crossfade without a click, and the output ends up
+    // that of a render that stayed in Binaural.
+    juce::String checkModeSwitch()
+    {
+        auto output = makeTones (3.5);
+        auto reference = output;
+        struct Switch { int block; const char* parameter; float value; };
+        const Switch switches[] { { 56, "renderer", 1.0f }, { 112, "renderer", 0.0f }, { 168, "mode", 0.0f }, { 224, "mode", 1.0f } };
+        bool stayedLoaded = true;
+
+        BinauralPannerAudioProcessor processor, stayed;
+        prepareForCheck (processor, -30.0f);
+        prepareForCheck (stayed, -30.0f);
+
+        renderBlocks (output.getNumSamples(), checkBlockSize, checkSampleRate, true, [&] (int start, int n)
+        {
+            for (const auto& s : switches)
+                if (start == s.block * checkBlockSize)
+                    setParameter (processor, s.parameter, s.value);
+
+            processInPlace (processor, output, start, n);
+            processInPlace (stayed, reference, start, n);
+            stayedLoaded = stayedLoaded && processor.isBinauralEngineLoaded();
+        });
+
+        if (! stayedLoaded)
+            return "the engine was released between mode switches";
+
+        const auto d = compareTail (output, reference);
+
+        if (! d.matches())
+            return "the convolvers are not heard after the last switch (sample " + juce::String (d.first) + ")";
+
+        const int click = findClick (output, checkSettleSamples);
+
+        if (click >= 0)
+            return "click at sample " + juce::String (click);
+
+        return {};
+    }
+
+    // Lookahead in real time against an offline render without it (which waits for every
+    // load, so its cell switches land where the automation says): the live output must be
+    // the offline one exactly N samples later. The source steps to the next cell every
+    // 100 ms. N is a whole number of blocks (and, for power-of-two sizes, of control
+    // periods), so both split the same sub-blocks.
+    juce::String checkLookaheadAlignment()
+    {
+        for (const int blockSize : checkBlockSizes)
+        {
+            const int lookahead = blockSize * ((4096 + blockSize - 1) / blockSize);
+            const int numSamples = (int) checkSampleRate / blockSize * blockSize;
+            const int stepSamples = (int) (0.1 * checkSampleRate);
+            const auto input = makeNoise (numSamples + lookahead);
+
+            auto render = [&] (int lookaheadSamples, bool realtime)
+            {
+                BinauralPannerAudioProcessor processor;
+                processor.setNonRealtime (! realtime);
+                processor.setLookaheadSamples (lookaheadSamples);
+                prepareForCheck (processor, -85.0f, checkSampleRate, blockSize);
+
+                auto output = input;
+
+                renderBlocks (output.getNumSamples(), blockSize, checkSampleRate, realtime, [&] (int start, int n)
+                {
+                    // -85 .. 75 degrees in 10 degree steps, changing on block starts only
+                    setParameter (processor, "azimuth", -85.0f + 10.0f * (float) ((start / stepSamples) % 17));
+                    processInPlace (processor, output, start, n);
+                });
+
+                return output;
+            };
+
+            const auto offline = render (0, false);
+            const auto live = render (lookahead, true);
+            const auto d = compare (live, offline, { 0, numSamples }, 1.0e-4, lookahead);
+
+            if (! d.matches())
+                return "block size " + juce::String (blockSize) + ": the output is not the offline render "
+                       + juce::String (lookahead) + " samples later (max error " + juce::String (d.maxError) + ")";
+        }
+
+        return {};
+    }
+
+    // Warm-up on a renderer switch: one processor renders HRIR Binaural throughout, the
+    // other switches to the Head Model renderer (its convolvers stop and go stale) and back,
+    // where they are warmed up from the input history on the worker pool. Once warm, the
+    // next block through both processors' convolvers must be the same: warmed up means
+    // exactly as if they had never stopped.
+    juce::String checkWarmUpContinuity()
+    {
+        for (const int blockSize : checkBlockSizes)
+        {
+            const int switchBlocks = juce::jmax (1, (int) (0.25 * checkSampleRate) / blockSize);
+            const auto input = makeNoise (blockSize);
+
+            BinauralPannerAudioProcessor continuous, switched;
+            prepareForCheck (continuous, 30.0f, checkSampleRate, blockSize);
+            prepareForCheck (switched, 30.0f, checkSampleRate, blockSize);
+
+            juce::AudioBuffer<float> buffer (2, blockSize);
+
+            auto processBoth = [&]
+            {
+                for (auto* p : { &continuous, &switched })
+                {
+                    buffer.makeCopyOf (input, true);
+                    processInPlace (*p, buffer, 0, blockSize);
+                }
+            };
+
+            // HRIR, Head Model, then HRIR until the warm-up is done
+            for (int i = 0; i < switchBlocks; ++i)
+                processBoth();
+
+            setParameter (switched, "renderer", 1.0f);
+
+            for (int i = 0; i < switchBlocks; ++i)
+                processBoth();
+
+            setParameter (switched, "renderer", 0.0f);
+
+            const auto start = juce::Time::getHighResolutionTicks();
+
+            while (! BinauralCheckAccess::isEngineWarm (switched))
+            {
+                if (juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start) > 2.0)
+                    return "block size " + juce::String (blockSize) + ": the convolvers were not warmed up within 2 s";
+
+                processBoth();
+                juce::Thread::sleep (1); // the warm-up runs on the worker pool
+            }
+
+            // The first block the switched convolvers render once warm
+            juce::AudioBuffer<float> outContinuous (2, blockSize), outSwitched (2, blockSize);
+            outContinuous.clear();
+            outSwitched.clear();
+
+            for (const bool right : { false, true })
+            {
+                const int ch = right ? 1 : 0;
+                BinauralCheckAccess::getConvolver (continuous, right)
+                    .processAndAdd (input.getReadPointer (ch), outContinuous.getWritePointer (0), outContinuous.getWritePointer (1), blockSize);
+                BinauralCheckAccess::getConvolver (switched, right)
+                    .processAndAdd (input.getReadPointer (ch), outSwitched.getWritePointer (0), outSwitched.getWritePointer (1), blockSize);
+            }
+
+            const auto d = compare (outSwitched, outContinuous, { 0, blockSize }, 1.0e-5);
+
+            if (! d.matches())
+                return "block size " + juce::String (blockSize) + ": the first block after the warm-up differs from "
+                       "convolvers that never stopped (max error " + juce::String (d.maxError) + ")";
+        }
+
+        return {};
+    }
+
+    //==============================================================================
+    using Check = juce::String (*)();
+
+    const std::pair<const char*, Check> checks[] { { "seek",                checkSeek },
+                                                   { "engine_release",      checkEngineRelease },
+                                                   { "mode_switch",         checkModeSwitch },
+                                                   { "lookahead_alignment", checkLookaheadAlignment },
+                                                   { "warmup_continuity",   checkWarmUpContinuity } };
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // APVTS needs a message manager; it never opens a display.
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    juce::ArgumentList args (argc, argv);
+
+    if (args.containsOption ("--help|-h"))
+    {
+        std::cout << "BinauralChecks [--only <name substring>]\n\nChecks:";
+
+        for (const auto& c : checks)
+            std::cout << " " << c.first;
+
+        std::cout << "\n";
+        return 0;
+    }
+
+    const auto only = args.containsOption ("--only") ? args.getValueForOption ("--only") : juce::String();
+    std::atomic<int> failures { 0 };
+
+    // The engine's timer runs on the message thread: the loop runs here while the checks
+    // render on another thread
+    juce::Thread::launch ([&]
+    {
+        for (const auto& c : checks)
+        {
+            if (only.isNotEmpty() && ! juce::String (c.first).contains (only))
+                continue;
+
+            const auto error = c.second();
+            std::cout << c.first << ": " << (error.isEmpty() ? juce::String ("ok") : "FAILED, " + error) << std::endl;
+            failures += error.isEmpty() ? 0 : 1;
+        }
+
+        juce::MessageManager::getInstance()->stopDispatchLoop();
+    });
+
+    juce::MessageManager::getInstance()->runDispatchLoop();
+    return failures.load() == 0 ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+"""
+Stand-in head tracker: sends OSC "/head/ypr" (yaw, pitch, roll in degrees) over UDP.
+
+Use it to test the plugin's head-tracker input without hardware. By default it
+sweeps the yaw back and forth at 100 Hz. With --stdin it reads "yaw pitch roll"
+lines from standard input instead.
+
+Usage:
+  python3 send_ypr.py [--port 9000] [--rate 100] [--range 60] [--period 4] [--stdin]
+
+Standard library only.
+"""
+
+import argparse
+import math
+import socket
+import struct
+import sys
+import time
+
+
+def osc_string(s: str) -> bytes:
+    b = s.encode("ascii") + b"\0"
+    return b + b"\0" * (-len(b) % 4)
+
+
+def ypr_message(yaw: float, pitch: float, roll: float) -> bytes:
+    return osc_string("/head/ypr") + osc_string(",fff") + struct.pack(">fff", yaw, pitch, roll)
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=9000)
+    parser.add_argument("--rate", type=float, default=100.0, help="packets per second (sweep mode)")
+    parser.add_argument("--range", type=float, default=60.0, help="yaw sweep amplitude in degrees")
+    parser.add_argument("--period", type=float, default=4.0, help="sweep period in seconds")
+    parser.add_argument("--stdin", action="store_true", help="read 'yaw pitch roll' lines from stdin")
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    target = (args.host, args.port)
+
+    if args.stdin:
+        for line in sys.stdin:
+            parts = line.split()
+            if len(parts) != 3:
+                continue
+            sock.sendto(ypr_message(*map(float, parts)), target)
+        return 0
+
+    start = time.monotonic()
+    interval = 1.0 / args.rate
+    next_send = start
+
+    try:
+        while True:
+            t = time.monotonic() - start
+            yaw = args.range * math.sin(2.0 * math.pi * t / args.period)
+            sock.sendto(ypr_message(yaw, 0.0, 0.0), target)
+
+            next_send += interval
+            time.sleep(max(0.0, next_send - time.monotonic()))
+    except KeyboardInterrupt:
+        return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
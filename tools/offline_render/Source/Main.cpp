@@ -0,0 +1,490 @@
+/*
+  ==============================================================================
+
+    BinauralRender - headless offline renderer.
+
+    Links BinauralPannerAudioProcessor (without the editor) and renders files to
+    binaural in parallel, one processor instance per file.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+
+#include <iostream>
+#include <mutex>
+
+namespace
+{
+    //==============================================================================
+    // Automation: either a static position or a time-stamped trajectory.
+    //
+    // Text file, one point per line, '#' starts a comment:
+    //     <time seconds>  <azimuth deg>  <elevation deg>  [width 0..1]  [distance m]
+    // A single line (or --az/--el/--width/--distance) is a static position. Between points the
+    // values are interpolated linearly; before the first / after the last they hold.
+    struct AutomationPoint
+    {
+        double time = 0.0;
+        float az = 0.0f, el = 0.0f, width = 1.0f, distance = 1.0f;
+    };
+
+    struct Automation
+    {
+        std::vector<AutomationPoint> points { AutomationPoint{} };
+
+        AutomationPoint valueAt (double t) const
+        {
+            if (t <= points.front().time || points.size() == 1)
+                return points.front();
+
+            for (size_t i = 1; i < points.size(); ++i)
+            {
+                const auto& p0 = points[i - 1];
+                const auto& p1 = points[i];
+
+                if (t < p1.time)
+                {
+                    const auto alpha = (float) ((t - p0.time) / juce::jmax (1.0e-9, p1.time - p0.time));
+                    return { t,
+                             p0.az    + alpha * (p1.az    - p0.az),
+                             p0.el    + alpha * (p1.el    - p0.el),
+                             p0.width + alpha * (p1.width - p0.width),
+                             p0.distance + alpha * (p1.distance - p0.distance) };
+                }
+            }
+
+            return points.back();
+        }
+    };
+
+    bool parseAutomationFile (const juce::File& file, Automation& result, juce::String& error)
+    {
+        std::vector<AutomationPoint> points;
+        int lineNumber = 0;
+
+        for (auto line : juce::StringArray::fromLines (file.loadFileAsString()))
+        {
+            ++lineNumber;
+            line = line.upToFirstOccurrenceOf ("#", false, false).trim();
+
+            if (line.isEmpty())
+                continue;
+
+            auto tokens = juce::StringArray::fromTokens (line, " \t,", "");
+            tokens.removeEmptyStrings();
+
+            if (tokens.size() < 3)
+            {
+                error = file.getFileName() + ":" + juce::String (lineNumber) + ": expected <time> <az> <el> [width] [distance]";
+                return false;
+            }
+
+            AutomationPoint p;
+            p.time  = tokens[0].getDoubleValue();
+            p.az    = juce::jlimit (-90.0f, 90.0f, tokens[1].getFloatValue());
+            p.el    = juce::jlimit (-90.0f, 90.0f, tokens[2].getFloatValue());
+            p.width = tokens.size() > 3 ? juce::jlimit (0.0f, 1.0f, tokens[3].getFloatValue()) : 1.0f;
+            p.distance = tokens.size() > 4 ? juce::jlimit (DistanceModel::minMetres, DistanceModel::maxMetres, tokens[4].getFloatValue()) : 1.0f;
+
+            if (! points.empty() && p.time < points.back().time)
+            {
+                error = file.getFileName() + ":" + juce::String (lineNumber) + ": times must not decrease";
+                return false;
+            }
+
+            points.push_back (p);
+        }
+
+        if (points.empty())
+        {
+            error = file.getFileName() + ": no automation points";
+            return false;
+        }
+
+        result.points = std::move (points);
+        return true;
+    }
+
+    //==============================================================================
+    struct RenderSettings
+    {
+        Automation automation;
+        int mode = 1;     // 0 = Stereo, 1 = Binaural
+        int renderer = 0; // 0 = HRIR, 1 = Head Model
+        int blockSize = 512;
+        int hrirTaps = 0; // at 44.1 kHz, 0 = full length
+        int lookaheadSamples = 0;
+        int bitsPerSample = 24;
+        juce::File outputDir;
+    };
+
+    struct RenderResult
+    {
+        juce::File input, output;
+        double audioSeconds = 0.0;
+        double renderSeconds = 0.0;
+        juce::String error;
+
+        bool ok() const { return error.isEmpty(); }
+    };
+
+    void setParameter (BinauralPannerAudioProcessor& processor, const juce::String& id, float value)
+    {
+        if (auto* param = processor.apvts.getParameter (id))
+            param->setValueNotifyingHost (param->convertTo0to1 (value));
+    }
+
+    void applyAutomation (BinauralPannerAudioProcessor& processor, const AutomationPoint& p)
+    {
+        setParameter (processor, "azimuth",   p.az);
+        setParameter (processor, "elevation", p.el);
+        setParameter (processor, "width",     p.width);
+        setParameter (processor, "distance",  p.distance);
+    }
+
+    // Sample-accurate changes inside a block (the parameters set its start)
+    void queueAutomation (BinauralPannerAudioProcessor& processor, int sampleOffset, const AutomationPoint& p)
+    {
+        using Param = BinauralPannerAudioProcessor::AutomatedParameter;
+
+        processor.addParameterChange (Param::azimuth,   sampleOffset, p.az);
+        processor.addParameterChange (Param::elevation, sampleOffset, p.el);
+        processor.addParameterChange (Param::width,     sampleOffset, p.width);
+        processor.addParameterChange (Param::distance,  sampleOffset, p.distance);
+    }
+
+    juce::File outputFileFor (const juce::File& input, const RenderSettings& settings)
+    {
+        const auto dir = settings.outputDir == juce::File() ? input.getParentDirectory() : settings.outputDir;
+        const auto ext = input.hasFileExtension ("flac") ? ".flac" : ".wav";
+        return dir.getChildFile (input.getFileNameWithoutExtension() + "_binaural" + ext);
+    }
+
+    // Files with more than two channels render as a speaker bed: the file's own layout (WAV
+    // channel mask) if the processor supports it, or for a file without one (discrete) the
+    // supported bed with its channel count. Disabled when neither fits.
+    juce::AudioChannelSet bedLayoutFor (juce::AudioFormatReader& reader)
+    {
+        const auto fileLayout = reader.getChannelLayout();
+
+        if (SpeakerBedRenderer::supportsLayout (fileLayout))
+            return fileLayout;
+
+        if (fileLayout.isDiscreteLayout())
+            for (const auto& bed : { juce::AudioChannelSet::create5point1(), juce::AudioChannelSet::create5point1point4(),
+                                     juce::AudioChannelSet::create7point1(), juce::AudioChannelSet::create7point1point4() })
+                if (bed.size() == (int) reader.numChannels)
+                    return bed;
+
+        return {};
+    }
+
+    RenderResult renderFile (const juce::File& input, const RenderSettings& settings)
+    {
+        RenderResult result;
+        result.input = input;
+        result.output = outputFileFor (input, settings);
+
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+
+        std::unique_ptr<juce::AudioFormatReader> reader (formats.createReaderFor (input));
+
+        if (reader == nullptr)
+        {
+            result.error = "cannot read " + input.getFullPathName();
+            return result;
+        }
+
+        const double sampleRate = reader->sampleRate;
+        const int numInputSamples = (int) reader->lengthInSamples;
+        const int numInputChannels = (int) reader->numChannels;
+        const auto bedLayout = numInputChannels > 2 ? bedLayoutFor (*reader) : juce::AudioChannelSet();
+
+        if (numInputChannels > 2 && bedLayout.isDisabled())
+        {
+            result.error = juce::String (numInputChannels) + " channels: not mono, stereo or a supported "
+                           "speaker bed (5.1, 5.1.4, 7.1, 7.1.4)";
+            return result;
+        }
+
+        // The panner takes a stereo pair; mono files feed both sides. Beds keep every channel.
+        const int numChannels = juce::jmax (2, numInputChannels);
+        juce::AudioBuffer<float> source (numChannels, numInputSamples);
+        reader->read (&source, 0, numInputSamples, 0, true, numInputChannels > 1);
+
+        if (numInputChannels == 1)
+            source.copyFrom (1, 0, source, 0, 0, numInputSamples);
+
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+
+        BinauralPannerAudioProcessor processor;
+        processor.setNonRealtime (true);
+        processor.setHrirLength (settings.hrirTaps);
+        processor.setLookaheadSamples (settings.lookaheadSamples);
+
+        if (bedLayout.isDisabled())
+        {
+            processor.setPlayConfigDetails (2, 2, sampleRate, settings.blockSize);
+        }
+        else
+        {
+            juce::AudioProcessor::BusesLayout layouts;
+            layouts.inputBuses.add (bedLayout);
+            layouts.outputBuses.add (juce::AudioChannelSet::stereo());
+
+            if (! processor.setBusesLayout (layouts))
+            {
+                result.error = "the processor does not accept the " + bedLayout.getDescription() + " layout";
+                return result;
+            }
+
+            processor.setRateAndBufferSizeDetails (sampleRate, settings.blockSize);
+        }
+
+        setParameter (processor, "mode", (float) settings.mode);
+        setParameter (processor, "renderer", (float) settings.renderer);
+        applyAutomation (processor, settings.automation.valueAt (0.0));
+        processor.prepareToPlay (sampleRate, settings.blockSize);
+
+        // The lookahead delay is rendered past the end and cut from the start, as a host's
+        // delay compensation would
+        const int latency = processor.getLatencySamples();
+        const int tailSamples = (int) std::ceil (processor.getTailLengthSeconds() * sampleRate);
+        const int outputSamples = numInputSamples + tailSamples;
+        const int totalSamples = outputSamples + latency;
+
+        juce::AudioBuffer<float> rendered (2, totalSamples);
+        juce::AudioBuffer<float> block (numChannels, settings.blockSize);
+        juce::MidiBuffer midi;
+
+        for (int pos = 0; pos < totalSamples; pos += settings.blockSize)
+        {
+            const int n = juce::jmin (settings.blockSize, totalSamples - pos);
+            const int fromSource = juce::jlimit (0, n, numInputSamples - pos);
+
+            applyAutomation (processor, settings.automation.valueAt ((double) pos / sampleRate));
+
+            // The trajectory inside the block at the control rate (fewer points in huge blocks)
+            const int automationStep = juce::jmax (processor.getControlBlockSize(),
+                                                   4 * n / BinauralPannerAudioProcessor::maxParameterChangesPerBlock + 1);
+
+            if (settings.automation.points.size() > 1)
+                for (int offset = automationStep; offset < n; offset += automationStep)
+                    queueAutomation (processor, offset, settings.automation.valueAt ((double) (pos + offset) / sampleRate));
+
+            // same channel pointers, exactly n samples: no allocation per block
+            juce::AudioBuffer<float> io (block.getArrayOfWritePointers(), numChannels, n);
+            io.clear();
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                if (fromSource > 0)
+                    io.copyFrom (ch, 0, source, ch, pos, fromSource);
+
+            processor.processBlock (io, midi);
+
+            for (int ch = 0; ch < 2; ++ch)
+                rendered.copyFrom (ch, pos, io, ch, 0, n);
+        }
+
+        processor.releaseResources();
+
+        result.renderSeconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+        result.audioSeconds = (double) outputSamples / sampleRate;
+
+        // Write
+        auto* format = formats.findFormatForFileExtension (result.output.getFileExtension());
+
+        if (format == nullptr)
+        {
+            result.error = "no writer for " + result.output.getFileExtension();
+            return result;
+        }
+
+        result.output.deleteFile();
+        auto stream = result.output.createOutputStream();
+
+        if (stream == nullptr || ! stream->openedOk())
+        {
+            result.error = "cannot write " + result.output.getFullPathName();
+            return result;
+        }
+
+        std::unique_ptr<juce::AudioFormatWriter> writer (format->createWriterFor (stream.get(), sampleRate, 2,
+                                                                                  settings.bitsPerSample, {}, 0));
+        if (writer == nullptr)
+        {
+            result.error = "cannot create writer for " + result.output.getFullPathName();
+            return result;
+        }
+
+        stream.release(); // now owned by the writer
+        writer->writeFromAudioSampleBuffer (rendered, latency, outputSamples);
+
+        return result;
+    }
+
+    //==============================================================================
+    void printUsage()
+    {
+        std::cout
+            << "BinauralRender - offline binaural rendering with the BinauralPanner engine\n\n"
+               "Usage: BinauralRender [options] <input.wav|flac> [more inputs...]\n\n"
+               "  --automation <file>   trajectory file: lines of '<time s> <az> <el> [width] [distance]'\n"
+               "  --az <deg>            static azimuth   (-90..90, default 0)\n"
+               "  --el <deg>            static elevation (-90..90, default 0)\n"
+               "  --width <0..1>        static width (default 1)\n"
+               "  --distance <m>        static distance (0.2..20, default 1)\n"
+               "                        (--az/--el/--width/--distance are ignored when --automation is given)\n"
+               "  --mode <binaural|stereo|head>\n"
+               "  --block <samples>     render block size (default 512)\n"
+               "  --hrir-taps <n>       HRIR length in taps at 44.1 kHz (default: full)\n"
+               "  --lookahead <n>       read the automation n samples ahead (default 0; the\n"
+               "                        delay is compensated, the output stays aligned)\n"
+               "  --bits <16|24|32>     output bit depth (default 24)\n"
+               "  --out <dir>           output directory (default: next to each input)\n"
+               "  --jobs <n>            files rendered in parallel (default: all cores)\n\n"
+               "Inputs are mono, stereo, or a 5.1, 5.1.4, 7.1 or 7.1.4 speaker bed (rendered through\n"
+               "the virtual speakers; the panner options do not apply).\n"
+               "Outputs are written as <name>_binaural.<ext>.\n";
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // APVTS needs a message manager; it never opens a display.
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    juce::ArgumentList args (argc, argv);
+
+    if (args.size() == 0 || args.containsOption ("--help|-h"))
+    {
+        printUsage();
+        return args.size() == 0 ? 1 : 0;
+    }
+
+    RenderSettings settings;
+    AutomationPoint staticPosition;
+    bool hasAutomationFile = false;
+    int numJobs = juce::SystemStats::getNumCpus();
+    juce::Array<juce::File> inputs;
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        const auto arg = args[i];
+
+        if (! arg.isOption())
+        {
+            inputs.add (arg.resolveAsFile());
+            continue;
+        }
+
+        if (i + 1 >= args.size())
+        {
+            std::cerr << "missing value for " << arg.text << "\n";
+            return 1;
+        }
+
+        const auto value = args[++i].text;
+
+        if      (arg.text == "--automation")
+        {
+            juce::String error;
+            if (! parseAutomationFile (juce::File::getCurrentWorkingDirectory().getChildFile (value), settings.automation, error))
+            {
+                std::cerr << error << "\n";
+                return 1;
+            }
+
+            hasAutomationFile = true;
+        }
+        else if (arg.text == "--az")     staticPosition.az    = juce::jlimit (-90.0f, 90.0f, value.getFloatValue());
+        else if (arg.text == "--el")     staticPosition.el    = juce::jlimit (-90.0f, 90.0f, value.getFloatValue());
+        else if (arg.text == "--width")  staticPosition.width = juce::jlimit (0.0f, 1.0f, value.getFloatValue());
+        else if (arg.text == "--distance") staticPosition.distance = juce::jlimit (DistanceModel::minMetres, DistanceModel::maxMetres, value.getFloatValue());
+        else if (arg.text == "--mode")
+        {
+            settings.mode     = value.toLowerCase() == "stereo" ? 0 : 1;
+            settings.renderer = value.toLowerCase() == "head"   ? 1 : 0;
+        }
+        else if (arg.text == "--block")  settings.blockSize = juce::jlimit (16, 65536, value.getIntValue());
+        else if (arg.text == "--hrir-taps") settings.hrirTaps = juce::jmax (0, value.getIntValue());
+        else if (arg.text == "--lookahead") settings.lookaheadSamples = juce::jlimit (0, BinauralPannerAudioProcessor::maxLookaheadSamples, value.getIntValue());
+        else if (arg.text == "--bits")   settings.bitsPerSample = value.getIntValue();
+        else if (arg.text == "--out")    settings.outputDir = juce::File::getCurrentWorkingDirectory().getChildFile (value);
+        else if (arg.text == "--jobs")   numJobs = juce::jmax (1, value.getIntValue());
+        else
+        {
+            std::cerr << "unknown option " << arg.text << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (inputs.isEmpty())
+    {
+        printUsage();
+        return 1;
+    }
+
+    if (! hasAutomationFile)
+        settings.automation.points = { staticPosition };
+
+    if (settings.outputDir != juce::File())
+        settings.outputDir.createDirectory();
+
+    //==============================================================================
+    std::vector<RenderResult> results ((size_t) inputs.size());
+    std::mutex printLock;
+
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+
+    {
+        juce::ThreadPool pool (juce::ThreadPoolOptions{}.withNumberOfThreads (juce::jmin (numJobs, inputs.size()))
+                                                        .withThreadName ("BinauralRender"));
+
+        for (int i = 0; i < inputs.size(); ++i)
+        {
+            pool.addJob ([&, i]
+            {
+                auto& r = results[(size_t) i];
+                r = renderFile (inputs[i], settings);
+
+                const std::lock_guard<std::mutex> lock (printLock);
+
+                if (r.ok())
+                    std::cout << r.input.getFileName() << " -> " << r.output.getFileName()
+                              << ": " << juce::String (r.audioSeconds, 2) << " s in "
+                              << juce::String (r.renderSeconds, 3) << " s ("
+                              << juce::String (r.audioSeconds / juce::jmax (1.0e-9, r.renderSeconds), 1)
+                              << "x realtime)\n";
+                else
+                    std::cerr << r.input.getFileName() << ": " << r.error << "\n";
+            });
+        }
+
+        // ~ThreadPool would cancel jobs that have not started yet, so wait for all of them
+        while (pool.getNumJobs() > 0)
+            juce::Thread::sleep (20);
+    }
+
+    const double wallSeconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+
+    double totalAudio = 0.0;
+    int failures = 0;
+
+    for (const auto& r : results)
+    {
+        totalAudio += r.audioSeconds;
+        failures += r.ok() ? 0 : 1;
+    }
+
+    std::cout << inputs.size() - failures << "/" << inputs.size() << " files, "
+              << juce::String (totalAudio, 1) << " s of audio in " << juce::String (wallSeconds, 2) << " s ("
+              << juce::String (totalAudio / juce::jmax (1.0e-9, wallSeconds), 1) << "x realtime overall)\n";
+
+    return failures == 0 ? 0 : 1;
+}